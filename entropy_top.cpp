@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \brief Code to show the progress files written by run_entropy jobs.
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <boost/format.hpp>
+
+#include "my_progress_record.h"
+
+#define I_READ_TRIES   100   /* Copies tried before a record is skipped */
+
+//##############################################################################
+// read_record().  Copies a consistent snapshot of a mapped progress file.  A
+// file shorter than a record is skipped, since reading past its end through
+// the map would raise SIGBUS.
+//##############################################################################
+
+bool
+read_record( const std::string& s_file, my_user::progress_record& record )
+{
+
+  struct stat file_stat;
+
+  int i_fd = open( s_file.c_str(), O_RDONLY );
+
+  if( i_fd < 0 ) return false;
+
+  if(
+    fstat( i_fd, &file_stat ) != 0 ||
+    file_stat.st_size < (off_t) sizeof( record )
+  )
+  {
+    close( i_fd );
+    return false;
+  }
+
+  void * p_map =
+    mmap( NULL, sizeof( record ), PROT_READ, MAP_SHARED, i_fd, 0 );
+
+  close( i_fd );
+
+  if( p_map == MAP_FAILED ) return false;
+
+  const my_user::progress_record * p_record =
+    static_cast<const my_user::progress_record *>( p_map );
+
+  bool b_ok = false;
+
+  for( int i = 0; i < I_READ_TRIES && !b_ok; i++ )
+  {
+    boost::uint64_t i_before = p_record->iSequence;
+    __sync_synchronize();
+    memcpy( &record, p_record, sizeof( record ) );
+    __sync_synchronize();
+    b_ok = i_before % 2 == 0 && p_record->iSequence == i_before;
+  }
+
+  munmap( p_map, sizeof( record ) );
+
+  return
+    b_ok &&
+    memcmp( record.sMagic, S_PROGRESS_MAGIC, sizeof( record.sMagic ) ) == 0;
+
+}
+
+//##############################################################################
+// state_name().
+//##############################################################################
+
+const char *
+state_name( const my_user::progress_record& record )
+{
+
+  if( record.iState == my_user::PROGRESS_DONE ) return "done";
+
+  if( record.iState == my_user::PROGRESS_FAILED ) return "failed";
+
+  if( record.iState == my_user::PROGRESS_CHECKPOINTED ) return "ckpt";
+
+  if( kill( (pid_t) record.iPid, 0 ) != 0 && errno == ESRCH ) return "dead";
+
+  return "running";
+
+}
+
+//##############################################################################
+// show().  Records are keyed by file name, since a pid can be reused.
+//##############################################################################
+
+void
+show( const std::string& s_dir )
+{
+
+  std::map<std::string, my_user::progress_record> records;
+  my_user::progress_record record;
+  struct dirent * p_entry;
+  struct timeval tv;
+  size_t i_suffix = strlen( S_PROGRESS_SUFFIX );
+
+  DIR * p_dir = opendir( s_dir.c_str() );
+
+  if( !p_dir )
+  {
+    std::cerr << "Could not open " << s_dir << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  while( ( p_entry = readdir( p_dir ) ) )
+  {
+    std::string s_name( p_entry->d_name );
+    if(
+      s_name.size() > i_suffix &&
+      s_name.compare( s_name.size() - i_suffix, i_suffix, S_PROGRESS_SUFFIX )
+        == 0 &&
+      read_record( s_dir + "/" + s_name, record )
+    )
+      records[s_name] = record;
+  }
+
+  closedir( p_dir );
+
+  gettimeofday( &tv, NULL );
+
+  double d_now = tv.tv_sec + 1.e-6 * tv.tv_usec;
+
+  std::cout <<
+    boost::format(
+      "%8s %-7s %10s %10s %10s %10s %10s %8s %8s %7s %7s %9s %8s  %s\n"
+    ) %
+    "pid" % "state" % "t" % "tend" % "dt" % "t9" % "rho" % "s" % "steps" %
+    "species" % "reacs" % "steps/s" % "age(s)" % "output";
+
+  for(
+    std::map<std::string, my_user::progress_record>::const_iterator it =
+      records.begin();
+    it != records.end();
+    ++it
+  )
+  {
+    const my_user::progress_record& r = it->second;
+    std::cout <<
+      boost::format(
+        "%8lu %-7s %10.3e %10.3e %10.3e %10.3e %10.3e %8.3f %8lu %7lu %7lu"
+        " %9.1f %8.0f  %s\n"
+      ) %
+      (unsigned long) r.iPid % state_name( r ) % r.dTime % r.dTend %
+      r.dDt % r.dT9 % r.dRho % r.dEntropy % (unsigned long) r.iSteps %
+      (unsigned long) r.iSpecies % (unsigned long) r.iReactions %
+      r.dStepsPerSecond % ( d_now - r.dWallUpdate ) %
+      std::string( r.sOutput, strnlen( r.sOutput, sizeof( r.sOutput ) ) );
+  }
+
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int main( int argc, char * argv[] ) {
+
+  if( argc != 2 && argc != 3 )
+  {
+    std::cerr << "\nUsage: " << argv[0] << " progress_dir [interval]\n\n" <<
+      "  progress_dir = directory given to run_entropy --progress_dir\n\n" <<
+      "  interval = seconds between refreshes (default: show once)\n\n";
+    exit( EXIT_FAILURE );
+  }
+
+  if( argc == 2 )
+  {
+    show( argv[1] );
+    return EXIT_SUCCESS;
+  }
+
+  unsigned int i_interval = (unsigned int) atoi( argv[2] );
+
+  if( i_interval == 0 )
+  {
+    std::cerr << "Interval must be a positive number of seconds." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  while( true )
+  {
+    std::cout << "\033[H\033[2J";
+    show( argv[1] );
+    std::cout << std::flush;
+    sleep( i_interval );
+  }
+
+}
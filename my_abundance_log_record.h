@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_abundance_log_record.h
+//! \brief A header file to define the abundance log layout shared by
+//!        run_entropy and print_abundance_log.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_ABUNDANCE_LOG_RECORD_H
+#define MY_ABUNDANCE_LOG_RECORD_H
+
+#include <boost/cstdint.hpp>
+
+#define S_ABUNDANCE_LOG_MAGIC  "ENTABUN1"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// Abundance log layout.
+//##############################################################################
+
+/**
+ * @brief The types of the abundance log's fields.
+ *
+ * The file starts with S_ABUNDANCE_LOG_MAGIC, the number of species
+ * (abundance_log_count_t), and for each species its index, Z, A, and name
+ * length (abundance_log_count_t) followed by the name.  Each record then
+ * holds the dump label (abundance_log_label_t), t, t9, rho, and entropy per
+ * nucleon (double), the number of non-zero abundances
+ * (abundance_log_count_t), and the (species index, abundance) pairs
+ * (abundance_log_count_t, double).  All numbers are in native byte order.
+ */
+
+typedef boost::uint32_t abundance_log_count_t;
+typedef boost::int32_t abundance_log_label_t;
+
+} // namespace my_user
+
+#endif // MY_ABUNDANCE_LOG_RECORD_H
@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_checkpoint_helper.cpp
+//! \brief A file to define wall-time budget and checkpoint helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cstring>
+
+#include <unistd.h>
+
+#include "my_checkpoint_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_checkpoint_descriptions().
+//##############################################################################
+
+void
+get_checkpoint_descriptions( po::options_description& checkpoint )
+{
+
+  try
+  {
+
+    checkpoint.add_options()
+
+      ( S_WALLTIME,
+        po::value<double>()->default_value( 0., "0." ),
+        "Wall-time budget (s) after which the run checkpoints and stops"
+        " (0 = no budget)"
+      )
+
+      ( S_WALLTIME_MARGIN,
+        po::value<double>()->default_value( 60., "60." ),
+        "Wall time (s) kept free before the budget ends to write the"
+        " checkpoint and output"
+      )
+
+      ( S_CHECKPOINT_FILE,
+        po::value<std::string>(),
+        "Checkpoint file written at the wall-time budget or on SIGTERM or"
+        " SIGUSR1 (default: the output file with .checkpoint appended)"
+      )
+
+      ( S_RESTART,
+        po::value<std::string>(),
+        "Checkpoint file to resume from.  Give the same input files and"
+        " options and a new output file.  The checkpoint holds the"
+        " abundances, the hydro state, t, dt, the step count, the dump"
+        " label, and whether freeze-out was found.  Dump labels continue, and"
+        " the abundance log and observer file are appended to.  The"
+        " Adams-Bashforth history, the T9 predictor, the time step"
+        " controller, and the freeze-out window start fresh, so a restarted"
+        " run does not reproduce an uninterrupted one.  Summary and store"
+        " output, flow output, the entropy breakdown, and events gather over"
+        " the whole run and are not checkpointed, so restart refuses them"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_checkpoint_options().
+//##############################################################################
+
+void
+set_checkpoint_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_WALLTIME] = vmap[S_WALLTIME].as<double>();
+
+  param_map[S_WALLTIME_MARGIN] = vmap[S_WALLTIME_MARGIN].as<double>();
+
+  if(
+    boost::any_cast<double>( param_map[S_WALLTIME] ) < 0 ||
+    boost::any_cast<double>( param_map[S_WALLTIME_MARGIN] ) < 0
+  )
+  {
+    std::cerr << "Wall time and margin must not be negative." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  if(
+    boost::any_cast<double>( param_map[S_WALLTIME] ) > 0 &&
+    boost::any_cast<double>( param_map[S_WALLTIME_MARGIN] ) >=
+      boost::any_cast<double>( param_map[S_WALLTIME] )
+  )
+  {
+    std::cerr << "Wall-time margin must be less than the wall time." <<
+      std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  if( vmap.count( S_CHECKPOINT_FILE ) )
+    param_map[S_CHECKPOINT_FILE] = vmap[S_CHECKPOINT_FILE].as<std::string>();
+
+  if( vmap.count( S_RESTART ) )
+    param_map[S_RESTART] = vmap[S_RESTART].as<std::string>();
+
+}
+
+//##############################################################################
+// walltime_budget::walltime_budget().  Only one budget should exist at a
+// time, since it owns the SIGTERM and SIGUSR1 handlers.
+//##############################################################################
+
+volatile sig_atomic_t walltime_budget::iSignal = 0;
+
+walltime_budget::walltime_budget(
+  double d_start,
+  double d_budget,
+  double d_margin
+) : dStart( d_start ), dBudget( d_budget ), dMargin( d_margin ),
+    dPredicted( -1. ), iSteps( 0 ), bWarned( false ), bStop( false )
+{
+
+  iSignal = 0;
+
+  std::signal( SIGTERM, on_signal );
+  std::signal( SIGUSR1, on_signal );
+
+}
+
+//##############################################################################
+// walltime_budget::~walltime_budget().
+//##############################################################################
+
+walltime_budget::~walltime_budget()
+{
+  std::signal( SIGTERM, SIG_DFL );
+  std::signal( SIGUSR1, SIG_DFL );
+}
+
+//##############################################################################
+// walltime_budget::on_signal().
+//##############################################################################
+
+void
+walltime_budget::on_signal( int i_signal )
+{
+
+  if( iSignal )
+  {
+    std::signal( i_signal, SIG_DFL );
+    raise( i_signal );
+    return;
+  }
+
+  iSignal = i_signal;
+
+}
+
+//##############################################################################
+// walltime_budget::update().  Call after each step with the new time and the
+// end time.  Returns true if the run should checkpoint and stop now.
+//##############################################################################
+
+bool
+walltime_budget::update( double d_t, double d_tend )
+{
+
+  double d_wall = wall_time();
+
+  iSteps++;
+
+  window.push_back( std::make_pair( d_wall, d_t ) );
+
+  if( window.size() > I_WALLTIME_WINDOW + 1 ) window.pop_front();
+
+  if( d_t >= d_tend ) return false;
+
+  if( iSignal )
+  {
+    bStop = true;
+    return true;
+  }
+
+  if( dBudget <= 0 || window.size() < 2 ) return false;
+
+  size_t i_window = window.size() - 1;
+
+  double d_mean =
+    ( window.back().first - window.front().first ) / i_window;
+
+  double d_left = dBudget - ( d_wall - dStart );
+
+  if( d_left < dMargin + D_WALLTIME_STEP_FACTOR * d_mean )
+  {
+    bStop = true;
+    return true;
+  }
+
+  if( i_window < I_WALLTIME_WINDOW ) return false;
+
+  double d_steps = 1.e99;
+
+  if( d_t > window.front().second )
+    d_steps =
+      i_window * ( d_tend - d_t ) / ( d_t - window.front().second );
+
+  if( window.front().second > 0 && d_t > window.front().second )
+    d_steps =
+      std::min(
+        d_steps,
+        i_window * log( d_tend / d_t ) / log( d_t / window.front().second )
+      );
+
+  dPredicted = d_steps * d_mean;
+
+  if( !bWarned && dPredicted > d_left - dMargin )
+  {
+    log_message(
+      LOG_WARN,
+      (
+        boost::format(
+          "Predicted %g s to reach the end time with %g s left; the run"
+          " will checkpoint before the deadline."
+        ) % dPredicted % ( d_left - dMargin )
+      ).str()
+    );
+    bWarned = true;
+  }
+
+  return false;
+
+}
+
+//##############################################################################
+// walltime_budget::report().
+//##############################################################################
+
+void
+walltime_budget::report( std::ostream& os ) const
+{
+
+  double d_mean = 0;
+
+  if( window.size() > 1 )
+    d_mean =
+      ( window.back().first - window.front().first ) / ( window.size() - 1 );
+
+  os << boost::format( "\nWall time: %g s for %lu steps (recent mean %g s)\n" )
+    % ( wall_time() - dStart ) % iSteps % d_mean;
+
+  if( bStop && iSignal )
+    os << boost::format( "Checkpointed on signal %d\n" ) % iSignal;
+  else if( bStop )
+    os << boost::format( "Checkpointed at the %g s budget\n" ) % dBudget;
+  else if( dPredicted >= 0 )
+    os << boost::format( "Last predicted time to the end: %g s\n" ) %
+      dPredicted;
+
+  os << std::endl;
+
+}
+
+//##############################################################################
+// Checkpoint file helpers.
+//##############################################################################
+
+template<typename T>
+static void
+put( std::vector<char>& buffer, const T& t )
+{
+  const char * p = reinterpret_cast<const char *>( &t );
+  buffer.insert( buffer.end(), p, p + sizeof( T ) );
+}
+
+static void
+put_string( std::vector<char>& buffer, const char * s )
+{
+  boost::uint32_t i_len = s ? strlen( s ) : 0;
+  put( buffer, i_len );
+  buffer.insert( buffer.end(), s, s + i_len );
+}
+
+template<typename T>
+static bool
+get( const std::vector<char>& buffer, size_t& i_pos, T& t )
+{
+  if( i_pos + sizeof( T ) > buffer.size() ) return false;
+  memcpy( &t, &buffer[i_pos], sizeof( T ) );
+  i_pos += sizeof( T );
+  return true;
+}
+
+static bool
+get_string( const std::vector<char>& buffer, size_t& i_pos, std::string& s )
+{
+  boost::uint32_t i_len;
+  if( !get( buffer, i_pos, i_len ) || i_pos + i_len > buffer.size() )
+    return false;
+  s.assign( buffer.begin() + i_pos, buffer.begin() + i_pos + i_len );
+  i_pos += i_len;
+  return true;
+}
+
+struct property_buffer
+{
+  std::vector<char> data;
+  boost::uint32_t iCount;
+};
+
+static int
+checkpoint_property_callback(
+  const char * s_name,
+  const char * s_tag1,
+  const char * s_tag2,
+  const char * s_value,
+  void * p_data
+)
+{
+
+  property_buffer& properties = *static_cast<property_buffer *>( p_data );
+
+  boost::uint32_t i_flags = ( s_tag1 ? 1 : 0 ) | ( s_tag2 ? 2 : 0 );
+
+  put( properties.data, i_flags );
+  put_string( properties.data, s_name );
+  put_string( properties.data, s_tag1 );
+  put_string( properties.data, s_tag2 );
+  put_string( properties.data, s_value );
+
+  properties.iCount++;
+
+  return 1;
+
+}
+
+//##############################################################################
+// write_checkpoint().  The file holds, after the magic string, the number of
+// species and state variables, t, dt, the state, the dump label, the step
+// count, the freeze-out flag, the zone properties as (flags, name, tag1,
+// tag2, value), and the abundances and abundance changes, all in native
+// byte order.  The file is written under a temporary name and then renamed,
+// so a run killed while writing leaves any earlier checkpoint intact.
+//##############################################################################
+
+void
+write_checkpoint(
+  const std::string& s_file,
+  nnt::Zone& zone,
+  const std::vector<double>& x,
+  double d_t,
+  double d_dt,
+  int k,
+  size_t i_step,
+  bool b_frozen
+)
+{
+
+  std::vector<char> buffer;
+  property_buffer properties;
+  gsl_vector * p_abundances, * p_changes;
+
+  properties.iCount = 0;
+
+  Libnucnet__Zone__iterateOptionalProperties(
+    zone.getNucnetZone(),
+    NULL,
+    NULL,
+    NULL,
+    (Libnucnet__Zone__optional_property_iterate_function)
+      checkpoint_property_callback,
+    &properties
+  );
+
+  p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+  p_changes = Libnucnet__Zone__getAbundanceChanges( zone.getNucnetZone() );
+
+  buffer.insert(
+    buffer.end(),
+    S_CHECKPOINT_MAGIC,
+    S_CHECKPOINT_MAGIC + strlen( S_CHECKPOINT_MAGIC )
+  );
+  put( buffer, (boost::uint32_t) p_abundances->size );
+  put( buffer, (boost::uint32_t) x.size() );
+  put( buffer, d_t );
+  put( buffer, d_dt );
+  for( size_t i = 0; i < x.size(); i++ ) put( buffer, x[i] );
+  put( buffer, (boost::int32_t) k );
+  put( buffer, (boost::uint64_t) i_step );
+  put( buffer, (boost::uint32_t) b_frozen );
+
+  put( buffer, properties.iCount );
+  buffer.insert( buffer.end(), properties.data.begin(), properties.data.end() );
+
+  for( size_t i = 0; i < p_abundances->size; i++ )
+    put( buffer, gsl_vector_get( p_abundances, i ) );
+  for( size_t i = 0; i < p_changes->size; i++ )
+    put( buffer, gsl_vector_get( p_changes, i ) );
+
+  gsl_vector_free( p_abundances );
+  gsl_vector_free( p_changes );
+
+  std::string s_tmp = s_file + ".tmp";
+
+  std::FILE * p_file = std::fopen( s_tmp.c_str(), "wb" );
+
+  if(
+    !p_file ||
+    std::fwrite( &buffer[0], 1, buffer.size(), p_file ) != buffer.size() ||
+    std::fflush( p_file ) != 0 ||
+    fsync( fileno( p_file ) ) != 0 ||
+    std::fclose( p_file ) != 0 ||
+    std::rename( s_tmp.c_str(), s_file.c_str() ) != 0
+  )
+  {
+    std::cerr << "Could not write checkpoint " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// read_checkpoint().  Restores the zone and sets the state and counters.
+//##############################################################################
+
+void
+read_checkpoint(
+  const std::string& s_file,
+  nnt::Zone& zone,
+  std::vector<double>& x,
+  double& d_t,
+  double& d_dt,
+  int& k,
+  size_t& i_step,
+  bool& b_frozen
+)
+{
+
+  std::vector<char> buffer;
+  char s_chunk[65536];
+  size_t i_read, i_pos = strlen( S_CHECKPOINT_MAGIC );
+  boost::uint32_t i_species, i_state, i_frozen, i_properties, i_flags;
+  boost::int32_t i_label;
+  boost::uint64_t i_steps;
+  std::string s_name, s_tag1, s_tag2, s_value;
+
+  std::FILE * p_file = std::fopen( s_file.c_str(), "rb" );
+
+  if( !p_file )
+  {
+    std::cerr << "Could not open checkpoint " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  while( ( i_read = std::fread( s_chunk, 1, sizeof( s_chunk ), p_file ) ) > 0 )
+    buffer.insert( buffer.end(), s_chunk, s_chunk + i_read );
+
+  std::fclose( p_file );
+
+  size_t i_net_species =
+    Libnucnet__Nuc__getNumberOfSpecies(
+      Libnucnet__Net__getNuc( Libnucnet__Zone__getNet( zone.getNucnetZone() ) )
+    );
+
+  bool b_valid =
+    buffer.size() >= i_pos &&
+    memcmp( &buffer[0], S_CHECKPOINT_MAGIC, i_pos ) == 0 &&
+    get( buffer, i_pos, i_species ) &&
+    get( buffer, i_pos, i_state ) &&
+    i_species == i_net_species &&
+    i_state == x.size() &&
+    get( buffer, i_pos, d_t ) &&
+    get( buffer, i_pos, d_dt );
+
+  for( size_t i = 0; b_valid && i < x.size(); i++ )
+    b_valid = get( buffer, i_pos, x[i] );
+
+  b_valid =
+    b_valid &&
+    get( buffer, i_pos, i_label ) &&
+    get( buffer, i_pos, i_steps ) &&
+    get( buffer, i_pos, i_frozen ) &&
+    get( buffer, i_pos, i_properties );
+
+  for( boost::uint32_t i = 0; b_valid && i < i_properties; i++ )
+  {
+    b_valid =
+      get( buffer, i_pos, i_flags ) &&
+      get_string( buffer, i_pos, s_name ) &&
+      get_string( buffer, i_pos, s_tag1 ) &&
+      get_string( buffer, i_pos, s_tag2 ) &&
+      get_string( buffer, i_pos, s_value );
+    if( b_valid )
+      Libnucnet__Zone__updateProperty(
+        zone.getNucnetZone(),
+        s_name.c_str(),
+        ( i_flags & 1 ) ? s_tag1.c_str() : NULL,
+        ( i_flags & 2 ) ? s_tag2.c_str() : NULL,
+        s_value.c_str()
+      );
+  }
+
+  if(
+    !b_valid ||
+    buffer.size() - i_pos != 2 * i_species * sizeof( double )
+  )
+  {
+    std::cerr << "Checkpoint " << s_file <<
+      " is not valid for this network." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  std::vector<double> y( 2 * i_species );
+
+  memcpy( &y[0], &buffer[i_pos], y.size() * sizeof( double ) );
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], i_species );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  view = gsl_vector_view_array( &y[i_species], i_species );
+
+  Libnucnet__Zone__updateAbundanceChanges( zone.getNucnetZone(), &view.vector );
+
+  k = i_label;
+  i_step = i_steps;
+  b_frozen = i_frozen != 0;
+
+}
+
+}  // namespace my_user
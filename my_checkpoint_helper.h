@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_checkpoint_helper.h
+//! \brief A header file to define wall-time budget and checkpoint helper
+//!        routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_CHECKPOINT_HELPER_H
+#define MY_CHECKPOINT_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_log_helper.h"
+#include "my_progress_helper.h"
+
+#define S_WALLTIME          "walltime"
+#define S_WALLTIME_MARGIN   "walltime_margin"
+#define S_CHECKPOINT_FILE   "checkpoint_file"
+#define S_RESTART           "restart"
+
+#define S_CHECKPOINT_MAGIC   "ENTCKPT1"
+#define S_CHECKPOINT_SUFFIX  ".checkpoint"
+
+#define I_WALLTIME_WINDOW    64  /* Steps in the rolling step-time average */
+#define I_CHECKPOINT_STATUS  75  /* Exit status after a checkpoint (EX_TEMPFAIL) */
+
+#define D_WALLTIME_STEP_FACTOR  2.  /* Mean step times kept free at the deadline */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// walltime_budget.
+//##############################################################################
+
+/**
+ * @brief A class to decide when a run must checkpoint and stop.
+ *
+ * The budget counts from the wall time given to the constructor.  After each
+ * step, update() adds the step to a rolling window of I_WALLTIME_WINDOW
+ * steps and returns true once the time left is less than the margin plus
+ * D_WALLTIME_STEP_FACTOR mean step times.  It also predicts the steps left
+ * to the end time as the smaller of two extrapolations of the window, one
+ * at constant steps per second of model time and one at constant steps per
+ * e-fold of model time, and warns once if they will not fit.  A budget of
+ * zero only checks for signals.  The first SIGTERM or SIGUSR1 makes the next
+ * update() return true, and a second one kills the run.
+ */
+
+class walltime_budget
+{
+
+  public:
+    walltime_budget( double, double, double );
+    ~walltime_budget();
+
+    bool update( double, double );
+    int signal() const { return iSignal; }
+    void report( std::ostream& ) const;
+
+  private:
+    double dStart, dBudget, dMargin, dPredicted;
+    std::deque<std::pair<double, double> > window;
+    size_t iSteps;
+    bool bWarned, bStop;
+
+    static volatile sig_atomic_t iSignal;
+
+    static void on_signal( int );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_checkpoint_descriptions( po::options_description& );
+
+void
+set_checkpoint_options( po::variables_map&, param_map_t& );
+
+void
+write_checkpoint(
+  const std::string&,
+  nnt::Zone&,
+  const std::vector<double>&,
+  double,
+  double,
+  int,
+  size_t,
+  bool
+);
+
+void
+read_checkpoint(
+  const std::string&,
+  nnt::Zone&,
+  std::vector<double>&,
+  double&,
+  double&,
+  int&,
+  size_t&,
+  bool&
+);
+
+} // namespace my_user
+
+#endif // MY_CHECKPOINT_HELPER_H
@@ -0,0 +1,399 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_cost_helper.cpp
+//! \brief A file to define run-cost estimation helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <sys/resource.h>
+
+#include "my_cost_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_cost_descriptions().
+//##############################################################################
+
+void
+get_cost_descriptions( po::options_description& cost )
+{
+
+  try
+  {
+
+    cost.add_options()
+
+      ( S_COST_ESTIMATE,
+        po::value<std::string>()->default_value( "no" ),
+        "Only run the probe steps and print the predicted wall time and"
+        " memory from the timing log; no output is written (yes or no)"
+      )
+
+      ( S_COST_PROBE_STEPS,
+        po::value<size_t>()->default_value( 5 ),
+        "Number of steps before the time step probe"
+      )
+
+      ( S_TIMING_LOG,
+        po::value<std::string>(),
+        "Timing log that finished runs append to and cost estimates fit"
+        " (default: none)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_cost_options().
+//##############################################################################
+
+void
+set_cost_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_COST_ESTIMATE] = vmap[S_COST_ESTIMATE].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_COST_ESTIMATE] ) != "yes" &&
+    boost::any_cast<std::string>( param_map[S_COST_ESTIMATE] ) != "no"
+  )
+  {
+    std::cerr << "cost_estimate must be yes or no." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_COST_PROBE_STEPS] = vmap[S_COST_PROBE_STEPS].as<size_t>();
+
+  if( boost::any_cast<size_t>( param_map[S_COST_PROBE_STEPS] ) == 0 )
+  {
+    std::cerr << "Number of cost probe steps must be positive." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  if( vmap.count( S_TIMING_LOG ) )
+    param_map[S_TIMING_LOG] = vmap[S_TIMING_LOG].as<std::string>();
+
+}
+
+//##############################################################################
+// peak_memory().  Peak resident memory (kB) of the process so far.
+//##############################################################################
+
+double
+peak_memory()
+{
+
+  struct rusage usage;
+
+  getrusage( RUSAGE_SELF, &usage );
+
+  return usage.ru_maxrss;
+
+}
+
+//##############################################################################
+// cost_model::cost_model().
+//##############################################################################
+
+cost_model::cost_model(
+  size_t i_probe_steps,
+  double d_tend
+) : iProbeSteps( i_probe_steps ), dSpecies( 0 ), dReactions( 0 ), dDt( 0 ),
+    dExpansion( d_tend ), dTend( d_tend )
+{}
+
+//##############################################################################
+// cost_model::probe_network().  Call with the evolution network view after
+// the initial limiting.
+//##############################################################################
+
+void
+cost_model::probe_network( Libnucnet__NetView * p_view )
+{
+
+  dSpecies =
+    Libnucnet__Nuc__getNumberOfSpecies(
+      Libnucnet__Net__getNuc( Libnucnet__NetView__getNet( p_view ) )
+    );
+
+  dReactions =
+    Libnucnet__Reac__getNumberOfReactions(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_view ) )
+    );
+
+}
+
+//##############################################################################
+// cost_model::probe_expansion().  x[0] is the radius scale and x[1] its rate
+// of change.  A run that does not expand has the end time as its timescale.
+//##############################################################################
+
+void
+cost_model::probe_expansion( const state_type& x )
+{
+
+  if( x[1] > 0 ) dExpansion = x[0] / x[1];
+
+}
+
+//##############################################################################
+// cost_model::probe_step().  Call after each time step update with the step
+// count and the new step.  Returns true once the probe steps are done.
+//##############################################################################
+
+bool
+cost_model::probe_step( size_t i_steps, double d_dt )
+{
+
+  if( i_steps <= iProbeSteps && d_dt > 0 ) dDt = d_dt;
+
+  return i_steps >= iProbeSteps;
+
+}
+
+//##############################################################################
+// cost_model::append().  Appends this run's record to the timing log with a
+// single write, so runs may share a log.
+//##############################################################################
+
+void
+cost_model::append(
+  const std::string& s_file,
+  double d_wall,
+  size_t i_steps,
+  const std::string& s_output
+) const
+{
+
+  std::FILE * p_file = std::fopen( s_file.c_str(), "a" );
+
+  if( !p_file )
+  {
+    std::cerr << "Could not open timing log " << s_file << std::endl;
+    return;
+  }
+
+  std::fseek( p_file, 0, SEEK_END );
+
+  std::string s_line;
+
+  if( std::ftell( p_file ) == 0 )
+    s_line =
+      "# species reactions dt expansion t_end wall_s memory_kb steps"
+      " output\n";
+
+  s_line +=
+    (
+      boost::format( "%.0f %.0f %.6e %.6e %.6e %.6e %.0f %lu %s\n" ) %
+      dSpecies % dReactions % dDt % dExpansion % dTend % d_wall %
+      peak_memory() % i_steps % s_output
+    ).str();
+
+  std::fputs( s_line.c_str(), p_file );
+
+  std::fclose( p_file );
+
+}
+
+//##############################################################################
+// cost_model::terms().  The model terms of a record.
+//##############################################################################
+
+void
+cost_model::terms( const timing_record& record, double * p_terms )
+{
+
+  p_terms[0] = 1.;
+  p_terms[1] = log( record.dSpecies );
+  p_terms[2] = log( record.dReactions );
+  p_terms[3] = log( record.dTend / record.dDt );
+  p_terms[4] = log( record.dExpansion / record.dDt );
+
+}
+
+//##############################################################################
+// cost_model::fit().  Fits the log of the given record member to the first
+// i_terms model terms and evaluates the fit for the target.  The factor is
+// the exponential of the rms residual.  Returns false if there are too few
+// records.
+//##############################################################################
+
+bool
+cost_model::fit(
+  const std::vector<timing_record>& records,
+  size_t i_terms,
+  double timing_record::* p_member,
+  const timing_record& target,
+  double& d_value,
+  double& d_factor
+)
+{
+
+  double t[I_COST_TIME_TERMS], d_chisq;
+
+  if( records.size() <= i_terms ) return false;
+
+  gsl_matrix * p_x = gsl_matrix_alloc( records.size(), i_terms );
+  gsl_vector * p_y = gsl_vector_alloc( records.size() );
+  gsl_vector * p_c = gsl_vector_alloc( i_terms );
+  gsl_matrix * p_cov = gsl_matrix_alloc( i_terms, i_terms );
+  gsl_multifit_linear_workspace * p_work =
+    gsl_multifit_linear_alloc( records.size(), i_terms );
+
+  for( size_t i = 0; i < records.size(); i++ )
+  {
+    terms( records[i], t );
+    for( size_t j = 0; j < i_terms; j++ ) gsl_matrix_set( p_x, i, j, t[j] );
+    gsl_vector_set( p_y, i, log( records[i].*p_member ) );
+  }
+
+  gsl_multifit_linear( p_x, p_y, p_c, p_cov, &d_chisq, p_work );
+
+  terms( target, t );
+
+  d_value = 0;
+  for( size_t j = 0; j < i_terms; j++ )
+    d_value += gsl_vector_get( p_c, j ) * t[j];
+
+  d_value = exp( d_value );
+  d_factor = exp( sqrt( d_chisq / ( records.size() - i_terms ) ) );
+
+  gsl_multifit_linear_free( p_work );
+  gsl_matrix_free( p_cov );
+  gsl_vector_free( p_c );
+  gsl_vector_free( p_y );
+  gsl_matrix_free( p_x );
+
+  return true;
+
+}
+
+//##############################################################################
+// cost_model::predict().  An empty file name means no timing log.
+//##############################################################################
+
+void
+cost_model::predict( const std::string& s_file, std::ostream& os ) const
+{
+
+  std::vector<timing_record> records;
+  timing_record target;
+  std::string s_line;
+  double d_value, d_factor;
+
+  target.dSpecies = dSpecies;
+  target.dReactions = dReactions;
+  target.dDt = dDt;
+  target.dExpansion = dExpansion;
+  target.dTend = dTend;
+
+  if( !s_file.empty() )
+  {
+
+    std::ifstream input( s_file.c_str() );
+
+    while( std::getline( input, s_line ) )
+    {
+      timing_record record;
+      std::istringstream line( s_line );
+      if( s_line.empty() || s_line[0] == '#' ) continue;
+      if(
+        line >> record.dSpecies >> record.dReactions >> record.dDt >>
+          record.dExpansion >> record.dTend >> record.dWall >>
+          record.dMemory &&
+        record.dSpecies > 0 && record.dReactions > 0 && record.dDt > 0 &&
+        record.dExpansion > 0 && record.dTend > 0 && record.dWall > 0 &&
+        record.dMemory > 0
+      )
+        records.push_back( record );
+    }
+
+  }
+
+  os << boost::format( "\nCost estimate (probes after %lu steps):\n" ) %
+    iProbeSteps;
+  os << boost::format( "  species = %.0f\n" ) % dSpecies;
+  os << boost::format( "  reactions = %.0f\n" ) % dReactions;
+  os << boost::format( "  dt = %g s\n" ) % dDt;
+  os << boost::format( "  expansion timescale = %g s\n" ) % dExpansion;
+  os << boost::format( "  probe memory = %.0f kB\n" ) % peak_memory();
+
+  if(
+    dDt > 0 &&
+    fit(
+      records, I_COST_TIME_TERMS, &timing_record::dWall, target,
+      d_value, d_factor
+    )
+  )
+    os << boost::format(
+      "  predicted wall time = %g s (spread factor %.3g)\n"
+    ) % d_value % d_factor;
+  else
+    os << boost::format(
+      "  predicted wall time = unknown (%lu timing records; need %d)\n"
+    ) % records.size() % ( I_COST_TIME_TERMS + 1 );
+
+  if(
+    dDt > 0 &&
+    fit(
+      records, I_COST_MEMORY_TERMS, &timing_record::dMemory, target,
+      d_value, d_factor
+    )
+  )
+    os << boost::format(
+      "  predicted memory = %.0f kB (spread factor %.3g)\n"
+    ) % d_value % d_factor;
+  else
+    os << boost::format(
+      "  predicted memory = unknown (%lu timing records; need %d)\n"
+    ) % records.size() % ( I_COST_MEMORY_TERMS + 1 );
+
+  os << std::endl;
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_cost_helper.h
+//! \brief A header file to define run-cost estimation helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_COST_HELPER_H
+#define MY_COST_HELPER_H
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gsl/gsl_multifit.h>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_hydro_helper.h"
+
+#define S_COST_ESTIMATE      "cost_estimate"
+#define S_COST_PROBE_STEPS   "cost_probe_steps"
+#define S_TIMING_LOG         "timing_log"
+
+#define I_COST_TIME_TERMS    5  /* Coefficients of the wall-time model */
+#define I_COST_MEMORY_TERMS  4  /* Coefficients of the memory model */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// cost_model.
+//##############################################################################
+
+/**
+ * @brief A class to probe a run and predict its cost from past runs.
+ *
+ * The probes are the numbers of species and reactions in the evolution
+ * network after limiting at the initial T9, the time step after the given
+ * number of steps, and the initial expansion timescale x[0] / x[1], which
+ * tau and delta_traj set.  A finished run appends its probes, end time,
+ * wall time, peak resident memory, and step count as one line of a timing
+ * log.  predict() fits the log of the wall time by least squares to a
+ * constant and the logs of the species and reaction counts, of t_end / dt,
+ * and of the expansion timescale / dt, and fits the log of the peak memory
+ * to the first four of these terms.  It then prints the predictions for
+ * this run with the spread of the fit as a factor.
+ */
+
+class cost_model
+{
+
+  public:
+    cost_model( size_t, double );
+
+    void probe_network( Libnucnet__NetView * );
+    void probe_expansion( const state_type& );
+    bool probe_step( size_t, double );
+    void append( const std::string&, double, size_t, const std::string& ) const;
+    void predict( const std::string&, std::ostream& ) const;
+
+  private:
+    struct timing_record
+    {
+      double dSpecies, dReactions, dDt, dExpansion, dTend, dWall, dMemory;
+    };
+
+    size_t iProbeSteps;
+    double dSpecies, dReactions, dDt, dExpansion, dTend;
+
+    static void terms( const timing_record&, double * );
+    static bool fit(
+      const std::vector<timing_record>&,
+      size_t,
+      double timing_record::*,
+      const timing_record&,
+      double&,
+      double&
+    );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_cost_descriptions( po::options_description& );
+
+void
+set_cost_options( po::variables_map&, param_map_t& );
+
+double
+peak_memory();
+
+} // namespace my_user
+
+#endif // MY_COST_HELPER_H
@@ -0,0 +1,453 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_decay_helper.cpp
+//! \brief A file to define decay-only evolution helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_decay_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_decay_descriptions().
+//##############################################################################
+
+void
+get_decay_descriptions( po::options_description& decay )
+{
+
+  try
+  {
+
+    decay.add_options()
+
+      ( S_DECAY_T9,
+        po::value<double>()->default_value( 0., "0" ),
+        "T9 below which to try a decay-only jump to the end time"
+        " (0 = never; off with flow output or the entropy breakdown)"
+      )
+
+      ( S_DECAY_TOLERANCE,
+        po::value<double>()->default_value( 1.e-3, "1.e-3" ),
+        "Largest relative change from non-decay flows or entropy generation"
+        " allowed over a decay-only jump"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_decay_options().
+//##############################################################################
+
+void
+set_decay_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_DECAY_T9] = vmap[S_DECAY_T9].as<double>();
+
+  if( boost::any_cast<double>( param_map[S_DECAY_T9] ) < 0 )
+  {
+    std::cerr << "Decay T9 must not be negative." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_DECAY_TOLERANCE] = vmap[S_DECAY_TOLERANCE].as<double>();
+
+  if( boost::any_cast<double>( param_map[S_DECAY_TOLERANCE] ) <= 0 )
+  {
+    std::cerr << "Decay tolerance must be positive." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// decay_solver::decay_solver().
+//##############################################################################
+
+decay_solver::decay_solver(
+  Libnucnet__Net * p_net,
+  double d_tolerance
+) : pNet( p_net ), dTolerance( d_tolerance ), iChecks( 0 ), iJumps( 0 ),
+    iClamped( 0 ), dJump( 0 ), dClampedMax( 0 )
+{}
+
+//##############################################################################
+// decay_solver::prepare().  Collects the decays of the view, their rates, and
+// a topological order of the species.  The rates come from the zone's
+// current rates with every abundance set to one.  Returns false if the
+// decays form a cycle.
+//##############################################################################
+
+bool
+decay_solver::prepare( nnt::Zone& zone, Libnucnet__NetView * p_view )
+{
+
+  Libnucnet__Nuc * p_nuc = Libnucnet__Net__getNuc( pNet );
+  size_t i_species = Libnucnet__Nuc__getNumberOfSpecies( p_nuc );
+
+  parents.clear();
+  rates.clear();
+  daughters.clear();
+  daughter_offsets.assign( 1, 0 );
+  lambda.assign( i_species, 0. );
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  gsl_vector * p_ones = gsl_vector_alloc( i_species );
+  gsl_vector_set_all( p_ones, 1. );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), p_ones );
+
+  nnt::reaction_list_t reaction_list =
+    nnt::make_reaction_list(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_view ) )
+    );
+
+  BOOST_FOREACH( nnt::Reaction reaction, reaction_list )
+  {
+
+    nnt::reaction_element_list_t reactant_list =
+      nnt::make_reaction_reactant_list( reaction.getNucnetReaction() );
+
+    nnt::reaction_element_list_t nuclide_reactant_list =
+      nnt::make_reaction_nuclide_reactant_list(
+        reaction.getNucnetReaction()
+      );
+
+    if( reactant_list.size() != 1 || nuclide_reactant_list.size() != 1 )
+      continue;
+
+    size_t i_parent =
+      Libnucnet__Species__getIndex(
+        Libnucnet__Nuc__getSpeciesByName(
+          p_nuc,
+          Libnucnet__Reaction__Element__getName(
+            nuclide_reactant_list.begin()->getNucnetReactionElement()
+          )
+        )
+      );
+
+    double d_rate =
+      user::compute_flows_for_reaction(
+        zone, reaction.getNucnetReaction()
+      ).first;
+
+    if( d_rate <= 0 ) continue;
+
+    parents.push_back( i_parent );
+    rates.push_back( d_rate );
+    lambda[i_parent] += d_rate;
+
+    nnt::reaction_element_list_t product_list =
+      nnt::make_reaction_nuclide_product_list( reaction.getNucnetReaction() );
+
+    BOOST_FOREACH( nnt::ReactionElement element, product_list )
+    {
+      daughters.push_back(
+        Libnucnet__Species__getIndex(
+          Libnucnet__Nuc__getSpeciesByName(
+            p_nuc,
+            Libnucnet__Reaction__Element__getName(
+              element.getNucnetReactionElement()
+            )
+          )
+        )
+      );
+    }
+
+    daughter_offsets.push_back( daughters.size() );
+
+  }
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), p_abundances );
+
+  gsl_vector_free( p_ones );
+  gsl_vector_free( p_abundances );
+
+  //============================================================================
+  // Kahn's algorithm on the parent to daughter edges.
+  //============================================================================
+
+  std::vector<size_t> in_degree( i_species, 0 );
+
+  for( size_t d = 0; d < parents.size(); d++ )
+    for( size_t j = daughter_offsets[d]; j < daughter_offsets[d + 1]; j++ )
+      in_degree[daughters[j]]++;
+
+  order.clear();
+
+  for( size_t i = 0; i < i_species; i++ )
+    if( in_degree[i] == 0 ) order.push_back( i );
+
+  std::vector<size_t> first( i_species + 1, 0 );
+
+  for( size_t d = 0; d < parents.size(); d++ ) first[parents[d] + 1]++;
+  for( size_t i = 0; i < i_species; i++ ) first[i + 1] += first[i];
+
+  std::vector<size_t> by_parent( parents.size() ), next( first );
+
+  for( size_t d = 0; d < parents.size(); d++ )
+    by_parent[next[parents[d]]++] = d;
+
+  for( size_t k = 0; k < order.size(); k++ )
+  {
+    size_t i = order[k];
+    for( size_t l = first[i]; l < first[i + 1]; l++ )
+    {
+      size_t d = by_parent[l];
+      for( size_t j = daughter_offsets[d]; j < daughter_offsets[d + 1]; j++ )
+        if( --in_degree[daughters[j]] == 0 ) order.push_back( daughters[j] );
+    }
+  }
+
+  return order.size() == i_species;
+
+}
+
+//##############################################################################
+// decay_solver::check().  The arguments after the view are the entropy
+// generation rate, the entropy, and the time left to the end.
+//##############################################################################
+
+bool
+decay_solver::check(
+  nnt::Zone& zone,
+  Libnucnet__NetView * p_view,
+  double d_sdot,
+  double d_entropy,
+  double d_span
+)
+{
+
+  iChecks++;
+
+  if( fabs( d_sdot ) * d_span > dTolerance * d_entropy ) return false;
+
+  if( !prepare( zone, p_view ) ) return false;
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  gsl_vector * p_flows =
+    Libnucnet__Zone__computeFlowVector( zone.getNucnetZone() );
+
+  std::vector<double> f( p_flows->data, p_flows->data + p_flows->size );
+
+  for( size_t d = 0; d < parents.size(); d++ )
+  {
+    double d_flow = rates[d] * gsl_vector_get( p_abundances, parents[d] );
+    f[parents[d]] += d_flow;
+    for( size_t j = daughter_offsets[d]; j < daughter_offsets[d + 1]; j++ )
+      f[daughters[j]] -= d_flow;
+  }
+
+  bool b_result = true;
+
+  for( size_t i = 0; i < f.size() && b_result; i++ )
+  {
+    if(
+      fabs( f[i] ) * d_span >
+      dTolerance * GSL_MAX( gsl_vector_get( p_abundances, i ), D_DECAY_Y_MIN )
+    )
+      b_result = false;
+  }
+
+  gsl_vector_free( p_flows );
+  gsl_vector_free( p_abundances );
+
+  return b_result;
+
+}
+
+//##############################################################################
+// decay_solver::evolve().  Each abundance is a sum of exponentials in time,
+// kept as a map from decay rate to coefficient.  Species are solved in
+// topological order, so the sources of a species are complete when it is
+// reached.
+//##############################################################################
+
+void
+decay_solver::evolve( nnt::Zone& zone, double d_dt )
+{
+
+  typedef std::map<double, double> terms_t;
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  std::vector<double> y0( p_abundances->data,
+    p_abundances->data + p_abundances->size );
+  std::vector<double> y( y0 );
+  std::vector<terms_t> sources( y.size() );
+
+  gsl_vector_free( p_abundances );
+
+  Libnucnet__Nuc * p_nuc = Libnucnet__Net__getNuc( pNet );
+  std::vector<double> a( y.size() );
+  double d_mass = 0, d_new_mass = 0;
+  size_t i_clamped = iClamped;
+
+  for( size_t i = 0; i < y.size(); i++ )
+  {
+    a[i] =
+      Libnucnet__Species__getA(
+        Libnucnet__Nuc__getSpeciesByIndex( p_nuc, i )
+      );
+    d_mass += a[i] * y0[i];
+  }
+
+  std::vector<std::vector<size_t> > decays_of( y.size() );
+
+  for( size_t d = 0; d < parents.size(); d++ )
+    decays_of[parents[d]].push_back( d );
+
+  BOOST_FOREACH( size_t i, order )
+  {
+
+    terms_t terms;
+    double d_lambda = lambda[i], d_sum = 0;
+
+    if( d_lambda > 0 )
+    {
+      terms_t::const_iterator it = sources[i].begin();
+      while( it != sources[i].end() )
+      {
+        if( fabs( it->first - d_lambda ) <= D_DECAY_SEPARATION * d_lambda )
+        {
+          d_lambda *= 1. + 2. * D_DECAY_SEPARATION;
+          it = sources[i].begin();
+        }
+        else
+          ++it;
+      }
+    }
+
+    for(
+      terms_t::const_iterator it = sources[i].begin();
+      it != sources[i].end();
+      ++it
+    )
+    {
+      double d_c = it->second / ( d_lambda - it->first );
+      terms[it->first] += d_c;
+      d_sum += d_c;
+    }
+
+    terms[d_lambda] += y0[i] - d_sum;
+
+    terms_t().swap( sources[i] );
+
+    y[i] = 0;
+
+    for( terms_t::const_iterator it = terms.begin(); it != terms.end(); ++it )
+      y[i] += it->second * exp( -it->first * d_dt );
+
+    if( y[i] < 0 )
+    {
+      iClamped++;
+      dClampedMax = std::max( dClampedMax, -a[i] * y[i] );
+      y[i] = 0;
+    }
+
+    BOOST_FOREACH( size_t d, decays_of[i] )
+    {
+      for( size_t j = daughter_offsets[d]; j < daughter_offsets[d + 1]; j++ )
+      {
+        for(
+          terms_t::const_iterator it = terms.begin();
+          it != terms.end();
+          ++it
+        )
+          sources[daughters[j]][it->first] +=
+            rates[d] * ( d_lambda / lambda[i] ) * it->second;
+      }
+    }
+
+  }
+
+  if( iClamped > i_clamped )
+  {
+    for( size_t i = 0; i < y.size(); i++ ) d_new_mass += a[i] * y[i];
+    if( d_new_mass > 0 )
+      for( size_t i = 0; i < y.size(); i++ ) y[i] *= d_mass / d_new_mass;
+  }
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  for( size_t i = 0; i < y.size(); i++ ) y0[i] = y[i] - y0[i];
+
+  view = gsl_vector_view_array( &y0[0], y0.size() );
+
+  Libnucnet__Zone__updateAbundanceChanges( zone.getNucnetZone(), &view.vector );
+
+  iJumps++;
+  dJump += d_dt;
+
+}
+
+//##############################################################################
+// decay_solver::report().
+//##############################################################################
+
+void
+decay_solver::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nDecay solver: %lu checks, %lu jumps over %g s, %lu decays,"
+      " %lu negative abundances set to zero (largest mass fraction %g)\n\n"
+    ) % iChecks % iJumps % dJump % parents.size() % iClamped % dClampedMax;
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_decay_helper.h
+//! \brief A header file to define decay-only evolution helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_DECAY_HELPER_H
+#define MY_DECAY_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "user/flow_utilities.h"
+
+#define S_DECAY_T9          "decay_t9"
+#define S_DECAY_TOLERANCE   "decay_tolerance"
+
+#define D_DECAY_Y_MIN       1.e-25  /* Abundance floor for the flow test */
+#define D_DECAY_SEPARATION  1.e-6   /* Smallest relative gap in decay rates */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// decay_solver.
+//##############################################################################
+
+/**
+ * @brief A class to evolve the network over a long interval when only
+ *        decays matter.
+ *
+ * Decays are the reactions in the evolution view with a single reactant,
+ * which must be a nuclide.  prepare() builds the decay tables.  check()
+ * builds them too and accepts the jump if, over the remaining time, the
+ * non-decay part of the flow vector would change no abundance by more than
+ * the tolerance, relative to the larger of the abundance and D_DECAY_Y_MIN,
+ * and the entropy generation would change the entropy by less than the
+ * tolerance.  evolve() then
+ * solves the constant linear decay system exactly with Bateman sums taken
+ * in topological order.  A decay rate that lies within D_DECAY_SEPARATION
+ * of the rate of an ancestor is moved by that fraction to keep the sums
+ * finite, and its branches are scaled with it so that mass is conserved.
+ * A sum that cancels to a negative abundance is set to zero, and the
+ * abundances are then rescaled to the mass before the jump; report() gives
+ * the number of such abundances and the largest mass fraction set to zero.
+ * Networks with decay cycles are never jumped.
+ */
+
+class decay_solver
+{
+
+  public:
+    decay_solver( Libnucnet__Net *, double );
+
+    bool prepare( nnt::Zone&, Libnucnet__NetView * );
+    bool check( nnt::Zone&, Libnucnet__NetView *, double, double, double );
+    void evolve( nnt::Zone&, double );
+    void report( std::ostream& ) const;
+
+  private:
+    Libnucnet__Net * pNet;
+    double dTolerance;
+    std::vector<size_t> parents, daughter_offsets, daughters, order;
+    std::vector<double> rates, lambda;
+    size_t iChecks, iJumps, iClamped;
+    double dJump, dClampedMax;
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_decay_descriptions( po::options_description& );
+
+void
+set_decay_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_DECAY_HELPER_H
@@ -0,0 +1,442 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_event_helper.cpp
+//! \brief A file to define event location helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_event_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_event_descriptions().
+//##############################################################################
+
+void
+get_event_descriptions( po::options_description& event )
+{
+
+  try
+  {
+
+    event.add_options()
+
+      ( S_EVENT_T9,
+        po::value<std::vector<double> >()->multitoken()->composing(),
+        "T9 levels at whose crossings to write snapshots (default: none)"
+      )
+
+      ( S_EVENT_RHO,
+        po::value<std::vector<double> >()->multitoken()->composing(),
+        "Density levels at whose crossings to write snapshots"
+        " (default: none)"
+      )
+
+      ( S_EVENT_SDOT_PEAK,
+        po::value<std::string>()->default_value( "no" ),
+        "Write a snapshot at each new peak of the entropy generation rate"
+        " (yes or no)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_event_options().
+//##############################################################################
+
+void
+set_event_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  std::vector<double> t9_levels, rho_levels;
+
+  if( vmap.count( S_EVENT_T9 ) )
+    t9_levels = vmap[S_EVENT_T9].as<std::vector<double> >();
+
+  if( vmap.count( S_EVENT_RHO ) )
+    rho_levels = vmap[S_EVENT_RHO].as<std::vector<double> >();
+
+  for( size_t i = 0; i < t9_levels.size(); i++ )
+  {
+    if( t9_levels[i] <= 0 )
+    {
+      std::cerr << "Event T9 levels must be positive." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+
+  for( size_t i = 0; i < rho_levels.size(); i++ )
+  {
+    if( rho_levels[i] <= 0 )
+    {
+      std::cerr << "Event density levels must be positive." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+
+  param_map[S_EVENT_T9] = t9_levels;
+
+  param_map[S_EVENT_RHO] = rho_levels;
+
+  param_map[S_EVENT_SDOT_PEAK] = vmap[S_EVENT_SDOT_PEAK].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_EVENT_SDOT_PEAK] ) != "yes" &&
+    boost::any_cast<std::string>( param_map[S_EVENT_SDOT_PEAK] ) != "no"
+  )
+  {
+    std::cerr << "Event sdot peak must be yes or no." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// event_locator::event_locator().
+//##############################################################################
+
+event_locator::event_locator(
+  const std::vector<double>& _t9_levels,
+  const std::vector<double>& _rho_levels,
+  bool b_sdot_peak
+) : t9_levels( _t9_levels ), rho_levels( _rho_levels ),
+    bSdotPeak( b_sdot_peak ), iNext( 0 ), iEvents( 0 ), dSdotPeak( 0 ),
+    bSdotRising( false ), bSaved( false )
+{}
+
+//##############################################################################
+// event_locator::save().
+//##############################################################################
+
+void
+event_locator::save( nnt::Zone& zone, sample& s ) const
+{
+
+  s.dTime = zone.getProperty<double>( nnt::s_TIME );
+  s.dT9 = zone.getProperty<double>( nnt::s_T9 );
+  s.dRho = zone.getProperty<double>( nnt::s_RHO );
+  s.dEntropy = zone.getProperty<double>( nnt::s_ENTROPY_PER_NUCLEON );
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  s.y.assign( p_abundances->data, p_abundances->data + p_abundances->size );
+
+  gsl_vector_free( p_abundances );
+
+}
+
+//##############################################################################
+// event_locator::apply().
+//##############################################################################
+
+void
+event_locator::apply( nnt::Zone& zone, const sample& s ) const
+{
+
+  zone.updateProperty( nnt::s_TIME, s.dTime );
+  zone.updateProperty( nnt::s_T9, s.dT9 );
+  zone.updateProperty( nnt::s_RHO, s.dRho );
+  zone.updateProperty( nnt::s_ENTROPY_PER_NUCLEON, s.dEntropy );
+
+  std::vector<double> y( s.y );
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+}
+
+//##############################################################################
+// event_locator::quadratic().  Interpolates a sample member at time t with
+// the three step ends around it, or the two if only two are known.
+//##############################################################################
+
+double
+event_locator::quadratic( double sample::* p_member, double t ) const
+{
+
+  size_t n = history.size(), k = 1;
+
+  while( k < n - 1 && history[k].dTime < t ) k++;
+
+  if( n == 2 )
+  {
+    const sample& a = history[0], & b = history[1];
+    return
+      a.*p_member +
+      ( b.*p_member - a.*p_member ) * ( t - a.dTime ) / ( b.dTime - a.dTime );
+  }
+
+  if( k == n - 1 ) k = n - 2;
+
+  const sample& a = history[k - 1], & b = history[k], & c = history[k + 1];
+
+  double d_ab = ( b.*p_member - a.*p_member ) / ( b.dTime - a.dTime );
+  double d_bc = ( c.*p_member - b.*p_member ) / ( c.dTime - b.dTime );
+  double d_abc = ( d_bc - d_ab ) / ( c.dTime - a.dTime );
+
+  return
+    a.*p_member + d_ab * ( t - a.dTime ) +
+    d_abc * ( t - a.dTime ) * ( t - b.dTime );
+
+}
+
+//##############################################################################
+// event_locator::find_crossings().  Bisects the interpolant within the last
+// step, whose ends bracket the level.
+//##############################################################################
+
+void
+event_locator::find_crossings(
+  double sample::* p_member,
+  const std::vector<double>& levels,
+  const char * s_name
+)
+{
+
+  const sample& a = history[history.size() - 2], & b = history.back();
+
+  for( size_t i = 0; i < levels.size(); i++ )
+  {
+
+    double f_a = a.*p_member - levels[i], f_b = b.*p_member - levels[i];
+
+    if( !( ( f_a < 0 && f_b >= 0 ) || ( f_a > 0 && f_b <= 0 ) ) ) continue;
+
+    double t_a = a.dTime, t_b = b.dTime;
+
+    for( size_t j = 0; j < 60 && t_b - t_a > 0; j++ )
+    {
+      double t_m = 0.5 * ( t_a + t_b );
+      double f_m = quadratic( p_member, t_m ) - levels[i];
+      if( ( f_m > 0 ) == ( f_a > 0 ) )
+      {
+        t_a = t_m;
+        f_a = f_m;
+      }
+      else
+        t_b = t_m;
+    }
+
+    event e;
+    e.dTime = t_b;
+    e.sName = ( boost::format( "%s = %g" ) % s_name % levels[i] ).str();
+    events.push_back( e );
+
+  }
+
+}
+
+//##############################################################################
+// event_locator::find_sdot_peak().  The entropy generation rate is the
+// derivative of the cubic through the four step ends, and a peak is where
+// the cubic's second derivative turns negative.  Only a peak within the last
+// step is taken, so the events stay in time order.  A peak that the cubic
+// moves back across the step boundary is placed at the start of the step.
+//##############################################################################
+
+void
+event_locator::find_sdot_peak()
+{
+
+  double t[4], d[4];
+
+  for( size_t k = 0; k < 4; k++ )
+  {
+    t[k] = history[k].dTime;
+    d[k] = history[k].dEntropy;
+  }
+
+  for( size_t j = 1; j < 4; j++ )
+    for( size_t k = 3; k >= j; k-- )
+      d[k] = ( d[k] - d[k - 1] ) / ( t[k] - t[k - j] );
+
+  double d_curv_a = d[2] + d[3] * ( 3. * t[2] - t[0] - t[1] - t[2] );
+  double d_curv_b = d[2] + d[3] * ( 3. * t[3] - t[0] - t[1] - t[2] );
+
+  bool b_rising = bSdotRising;
+
+  bSdotRising = d_curv_b > 0;
+
+  if( d_curv_b > 0 || !( d_curv_a > 0 || b_rising ) ) return;
+
+  double d_peak = t[2];
+
+  if( d_curv_a > 0 )
+    d_peak = ( t[0] + t[1] + t[2] ) / 3. - d[2] / ( 3. * d[3] );
+
+  double d_sdot =
+    d[1] +
+    d[2] * ( ( d_peak - t[0] ) + ( d_peak - t[1] ) ) +
+    d[3] *
+    (
+      ( d_peak - t[1] ) * ( d_peak - t[2] ) +
+      ( d_peak - t[0] ) * ( d_peak - t[2] ) +
+      ( d_peak - t[0] ) * ( d_peak - t[1] )
+    );
+
+  if( !( d_sdot > dSdotPeak ) ) return;
+
+  dSdotPeak = d_sdot;
+
+  event e;
+  e.dTime = d_peak;
+  e.sName = "sdot peak";
+  events.push_back( e );
+
+}
+
+//##############################################################################
+// event_locator::update().  Call after each accepted step, once the zone
+// holds the new time, T9, density, entropy, and abundances.
+//##############################################################################
+
+void
+event_locator::update( nnt::Zone& zone )
+{
+
+  history.push_back( sample() );
+  save( zone, history.back() );
+
+  if( history.size() > I_EVENT_HISTORY ) history.pop_front();
+
+  events.clear();
+  iNext = 0;
+
+  if( history.size() < 2 ) return;
+
+  find_crossings( &sample::dT9, t9_levels, "t9" );
+
+  find_crossings( &sample::dRho, rho_levels, "rho" );
+
+  if( bSdotPeak && history.size() == I_EVENT_HISTORY ) find_sdot_peak();
+
+  std::sort( events.begin(), events.end() );
+
+}
+
+//##############################################################################
+// event_locator::next().  Sets the zone to the state at the next event of the
+// last step and returns true, or returns false if there are no more.
+//##############################################################################
+
+bool
+event_locator::next( nnt::Zone& zone )
+{
+
+  if( iNext == events.size() ) return false;
+
+  if( !bSaved )
+  {
+    save( zone, saved );
+    bSaved = true;
+  }
+
+  const event& e = events[iNext++];
+
+  size_t k = 1;
+
+  while( k < history.size() - 1 && history[k].dTime < e.dTime ) k++;
+
+  const sample& a = history[k - 1], & b = history[k];
+
+  double d_theta = ( e.dTime - a.dTime ) / ( b.dTime - a.dTime );
+
+  sample s;
+  s.dTime = e.dTime;
+  s.dT9 = quadratic( &sample::dT9, e.dTime );
+  s.dRho = quadratic( &sample::dRho, e.dTime );
+  s.dEntropy = quadratic( &sample::dEntropy, e.dTime );
+  s.y.resize( a.y.size() );
+
+  for( size_t i = 0; i < s.y.size(); i++ )
+    s.y[i] = a.y[i] + d_theta * ( b.y[i] - a.y[i] );
+
+  apply( zone, s );
+
+  zone.updateProperty( S_EVENT, e.sName );
+
+  iEvents++;
+
+  return true;
+
+}
+
+//##############################################################################
+// event_locator::restore().  Returns the zone to its state at the end of the
+// step.
+//##############################################################################
+
+void
+event_locator::restore( nnt::Zone& zone )
+{
+
+  if( !bSaved ) return;
+
+  apply( zone, saved );
+
+  Libnucnet__Zone__removeProperty( zone.getNucnetZone(), S_EVENT, NULL, NULL );
+
+  bSaved = false;
+
+}
+
+//##############################################################################
+// event_locator::report().
+//##############################################################################
+
+void
+event_locator::report( std::ostream& os ) const
+{
+
+  os << boost::format( "\nEvent locator: %lu event snapshots\n\n" ) % iEvents;
+
+}
+
+}  // namespace my_user
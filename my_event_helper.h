@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_event_helper.h
+//! \brief A header file to define event location helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_EVENT_HELPER_H
+#define MY_EVENT_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#define S_EVENT_T9          "event_t9"
+#define S_EVENT_RHO         "event_rho"
+#define S_EVENT_SDOT_PEAK   "event_sdot_peak"
+#define S_EVENT             "event"
+
+#define I_EVENT_HISTORY     4   /* Step ends kept for interpolation */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// event_locator.
+//##############################################################################
+
+/**
+ * @brief A class to locate events within accepted steps and to set the
+ *        zone to its interpolated state at each one.
+ *
+ * The events are crossings of the given T9 and density levels in either
+ * direction and, if asked for, peaks of the entropy generation rate that
+ * exceed every earlier peak.  T9, density, and entropy are interpolated by
+ * the quadratic through the last three step ends, and a crossing time is
+ * the root of that quadratic within the step.  The entropy generation rate
+ * is the derivative of the cubic through the last four step ends, and a
+ * peak is a maximum of that derivative within the last step, so events are
+ * found in time order.
+ * Abundances are interpolated linearly between step ends.  The step sizes
+ * are not touched.
+ */
+
+class event_locator
+{
+
+  public:
+    event_locator( const std::vector<double>&, const std::vector<double>&,
+      bool );
+
+    void update( nnt::Zone& );
+    bool next( nnt::Zone& );
+    void restore( nnt::Zone& );
+    void report( std::ostream& ) const;
+
+  private:
+    struct sample
+    {
+      double dTime, dT9, dRho, dEntropy;
+      std::vector<double> y;
+    };
+
+    struct event
+    {
+      double dTime;
+      std::string sName;
+      bool operator<( const event& e ) const { return dTime < e.dTime; }
+    };
+
+    std::vector<double> t9_levels, rho_levels;
+    bool bSdotPeak;
+    std::deque<sample> history;
+    std::vector<event> events;
+    size_t iNext, iEvents;
+    double dSdotPeak;
+    bool bSdotRising;
+    sample saved;
+    bool bSaved;
+
+    void save( nnt::Zone&, sample& ) const;
+    void apply( nnt::Zone&, const sample& ) const;
+    void find_crossings( double sample::*, const std::vector<double>&,
+      const char * );
+    void find_sdot_peak();
+    double quadratic( double sample::*, double ) const;
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_event_descriptions( po::options_description& );
+
+void
+set_event_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_EVENT_HELPER_H
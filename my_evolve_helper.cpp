@@ -0,0 +1,1407 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_evolve_helper.cpp
+//! \brief A file to define network evolution helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_evolve_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_evolve_descriptions().
+//##############################################################################
+
+void
+get_evolve_descriptions( po::options_description& evolve )
+{
+
+  try
+  {
+
+    evolve.add_options()
+
+      ( S_EVOLVER,
+        po::value<std::string>()->default_value( S_EVOLVER_DEFAULT ),
+        "Network evolver (default, bdf, rosenbrock, or jfnk)"
+      )
+
+      ( S_EVOLVER_RTOL,
+        po::value<double>()->default_value( 1.e-3, "1.e-3" ),
+        "Relative abundance tolerance for the bdf, rosenbrock, and jfnk"
+        " evolvers"
+      )
+
+      ( S_EVOLVER_ATOL,
+        po::value<double>()->default_value( 1.e-10, "1.e-10" ),
+        "Absolute abundance tolerance for the bdf, rosenbrock, and jfnk"
+        " evolvers"
+      )
+
+      ( S_BDF_MAX_ORDER,
+        po::value<size_t>()->default_value( I_BDF_MAX_ORDER ),
+        "Highest order (1 to 5) of the bdf evolver"
+      )
+
+      ( S_ROSENBROCK_SOLVER,
+        po::value<std::string>()->default_value( S_ROSENBROCK_ZONE ),
+        "Matrix solver of the rosenbrock evolver (zone or dense).  The"
+        " zone's solver factors the matrix on each of the four stages; dense"
+        " factors once per step but holds the full n x n matrix for n species"
+        " and costs O(n^3) per factorization"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_evolve_options().
+//##############################################################################
+
+void
+set_evolve_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_EVOLVER] = vmap[S_EVOLVER].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) !=
+      S_EVOLVER_DEFAULT &&
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) != S_EVOLVER_BDF &&
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) !=
+      S_EVOLVER_ROSENBROCK &&
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) != S_EVOLVER_JFNK
+  )
+  {
+    std::cerr << "Unknown evolver." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_EVOLVER_RTOL] = vmap[S_EVOLVER_RTOL].as<double>();
+  param_map[S_EVOLVER_ATOL] = vmap[S_EVOLVER_ATOL].as<double>();
+
+  if(
+    boost::any_cast<double>( param_map[S_EVOLVER_RTOL] ) <= 0 ||
+    boost::any_cast<double>( param_map[S_EVOLVER_ATOL] ) <= 0
+  )
+  {
+    std::cerr << "Evolver tolerances must be positive." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_BDF_MAX_ORDER] = vmap[S_BDF_MAX_ORDER].as<size_t>();
+
+  if(
+    boost::any_cast<size_t>( param_map[S_BDF_MAX_ORDER] ) < 1 ||
+    boost::any_cast<size_t>( param_map[S_BDF_MAX_ORDER] ) > I_BDF_MAX_ORDER
+  )
+  {
+    std::cerr << "BDF order must be between 1 and 5." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_ROSENBROCK_SOLVER] = vmap[S_ROSENBROCK_SOLVER].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_ROSENBROCK_SOLVER] ) !=
+      S_ROSENBROCK_ZONE &&
+    boost::any_cast<std::string>( param_map[S_ROSENBROCK_SOLVER] ) !=
+      S_ROSENBROCK_DENSE
+  )
+  {
+    std::cerr << "Rosenbrock solver must be zone or dense." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// network_evolver::network_evolver().
+//##############################################################################
+
+network_evolver::network_evolver(
+  nnt::Zone& _zone,
+  double d_rtol,
+  double d_atol
+) : zone( _zone ), dRtol( d_rtol ), dAtol( d_atol ), dH( 0 ), iCalls( 0 ),
+    iSteps( 0 ), iRejected( 0 ), iJacobians( 0 ), iFactorizations( 0 ),
+    iSolves( 0 )
+{}
+
+//##############################################################################
+// network_evolver::operator()().  Calls with a zero step, which the hydro
+// stepper makes at the start of a step, leave the zone alone.  The zone's
+// rate, flow, and Jacobian routines work on its evolution network, so that
+// must be the view passed in.
+//##############################################################################
+
+void
+network_evolver::operator()( Libnucnet__NetView * p_view, const double d_dt )
+{
+
+  if( d_dt <= 0 ) return;
+
+  if( p_view != zone.getNetView( EVOLUTION_NETWORK ) )
+  {
+    std::cerr <<
+      "Network evolvers only evolve the evolution network view." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  iCalls++;
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  vector_t y( p_abundances->data, p_abundances->data + p_abundances->size );
+  vector_t y0( y );
+
+  gsl_vector_free( p_abundances );
+
+  Libnucnet__Zone__computeRates(
+    zone.getNucnetZone(),
+    zone.getProperty<double>( nnt::s_T9 ),
+    zone.getProperty<double>( nnt::s_RHO )
+  );
+
+  integrate( y, d_dt );
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  for( size_t i = 0; i < y.size(); i++ ) y0[i] = y[i] - y0[i];
+
+  view = gsl_vector_view_array( &y0[0], y0.size() );
+
+  Libnucnet__Zone__updateAbundanceChanges(
+    zone.getNucnetZone(),
+    &view.vector
+  );
+
+}
+
+//##############################################################################
+// network_evolver::compute_rhs().
+//##############################################################################
+
+void
+network_evolver::compute_rhs( vector_t& y, vector_t& f )
+{
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  gsl_vector * p_flows =
+    Libnucnet__Zone__computeFlowVector( zone.getNucnetZone() );
+
+  f.assign( p_flows->data, p_flows->data + p_flows->size );
+
+  gsl_vector_free( p_flows );
+
+}
+
+//##############################################################################
+// network_evolver::compute_jacobian().
+//##############################################################################
+
+WnMatrix *
+network_evolver::compute_jacobian( vector_t& y )
+{
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  iJacobians++;
+
+  return Libnucnet__Zone__computeJacobian( zone.getNucnetZone() );
+
+}
+
+//##############################################################################
+// network_evolver::solve().  Solves with the zone's solver and returns the
+// solution in place of the right-hand side.  The matrix is left unchanged.
+// The zone's solvers factor the matrix on each call.
+//##############################################################################
+
+void
+network_evolver::solve( WnMatrix * p_matrix, vector_t& r )
+{
+
+  gsl_vector_view view = gsl_vector_view_array( &r[0], r.size() );
+
+  gsl_vector * p_sol =
+    user::solve_matrix_for_zone( zone, p_matrix, &view.vector );
+
+  if( !p_sol )
+  {
+    std::cerr << "Network matrix solve failed." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  std::copy( p_sol->data, p_sol->data + p_sol->size, r.begin() );
+
+  gsl_vector_free( p_sol );
+
+  iFactorizations++;
+  iSolves++;
+
+}
+
+//##############################################################################
+// network_evolver::error_norm().
+//##############################################################################
+
+double
+network_evolver::error_norm(
+  const vector_t& e,
+  const vector_t& y0,
+  const vector_t& y1
+) const
+{
+
+  double d_norm = 0;
+
+  for( size_t i = 0; i < e.size(); i++ )
+  {
+    double d_w = dRtol * std::max( fabs( y0[i] ), fabs( y1[i] ) ) + dAtol;
+    d_norm = std::max( d_norm, fabs( e[i] ) / d_w );
+  }
+
+  return d_norm;
+
+}
+
+//##############################################################################
+// bdf_evolver::bdf_evolver().
+//##############################################################################
+
+bdf_evolver::bdf_evolver(
+  nnt::Zone& _zone,
+  double d_rtol,
+  double d_atol,
+  size_t i_max_order
+) : network_evolver( _zone, d_rtol, d_atol ), iMaxOrder( i_max_order ),
+    iOrder( 1 ), iStepsAtOrder( 0 ), iNewton( 0 ),
+    order_counts( i_max_order + 1, 0 )
+{}
+
+//##############################################################################
+// bdf_evolver::start().  Commits the pending points if this call starts where
+// the last one ended, and resets the history if it starts anywhere other
+// than the last committed point.  Times are shifted so that the latest point
+// is at zero.
+//##############################################################################
+
+void
+bdf_evolver::start( const vector_t& y )
+{
+
+  if( !pending.empty() && pending.back().y == y )
+  {
+    history.insert( history.end(), pending.begin(), pending.end() );
+    while( history.size() > iMaxOrder + 2 ) history.pop_front();
+    double d_t0 = history.back().t;
+    for( size_t i = 0; i < history.size(); i++ ) history[i].t -= d_t0;
+  }
+  else if( history.empty() || history.back().y != y )
+  {
+    point p;
+    p.t = 0;
+    p.y = y;
+    history.assign( 1, p );
+    iOrder = 1;
+    iStepsAtOrder = 0;
+  }
+
+  pending.clear();
+
+}
+
+//##############################################################################
+// bdf_evolver::node().  Node 0 is the latest point.
+//##############################################################################
+
+const bdf_evolver::point&
+bdf_evolver::node( size_t i ) const
+{
+
+  if( i < pending.size() ) return pending[pending.size() - 1 - i];
+
+  return history[history.size() - 1 - ( i - pending.size() )];
+
+}
+
+size_t
+bdf_evolver::nodes() const
+{
+  return history.size() + pending.size();
+}
+
+//##############################################################################
+// bdf_evolver::extrapolate().  Evaluates the polynomial through nodes 0 to q
+// at time t.
+//##############################################################################
+
+void
+bdf_evolver::extrapolate( size_t i_q, double d_t, vector_t& y ) const
+{
+
+  y.assign( node( 0 ).y.size(), 0. );
+
+  for( size_t j = 0; j <= i_q; j++ )
+  {
+    double d_l = 1;
+    for( size_t m = 0; m <= i_q; m++ )
+    {
+      if( m != j )
+        d_l *= ( d_t - node( m ).t ) / ( node( j ).t - node( m ).t );
+    }
+    const vector_t& y_j = node( j ).y;
+    for( size_t i = 0; i < y.size(); i++ ) y[i] += d_l * y_j[i];
+  }
+
+}
+
+//##############################################################################
+// bdf_evolver::coefficients().  alpha[j] is the derivative at the new time
+// of the Lagrange basis polynomial for node j - 1 (j = 0 is the new point).
+//##############################################################################
+
+void
+bdf_evolver::coefficients(
+  size_t i_k,
+  double d_t,
+  std::vector<double>& alpha
+) const
+{
+
+  alpha.assign( i_k + 1, 0. );
+
+  for( size_t m = 1; m <= i_k; m++ )
+    alpha[0] += 1. / ( d_t - node( m - 1 ).t );
+
+  for( size_t j = 1; j <= i_k; j++ )
+  {
+    double d_tj = node( j - 1 ).t;
+    double d_prod = 1. / ( d_tj - d_t );
+    for( size_t m = 1; m <= i_k; m++ )
+    {
+      if( m != j )
+        d_prod *= ( d_t - node( m - 1 ).t ) / ( d_tj - node( m - 1 ).t );
+    }
+    alpha[j] = d_prod;
+  }
+
+}
+
+//##############################################################################
+// bdf_evolver::eta().  The step factor for an error at order q.
+//##############################################################################
+
+double
+bdf_evolver::eta( double d_error, size_t i_q, double d_bias ) const
+{
+  return 1. / ( pow( d_bias * d_error, 1. / ( i_q + 1 ) ) + 1.e-6 );
+}
+
+//##############################################################################
+// bdf_evolver::integrate().
+//##############################################################################
+
+void
+bdf_evolver::integrate( vector_t& y, double d_dt )
+{
+
+  std::vector<double> alpha;
+  vector_t y_pred, y_new, y_other, f, r, s;
+
+  start( y );
+
+  double d_t = node( 0 ).t, d_t_end = d_t + d_dt;
+  double d_h = dH > 0 ? std::min( dH, d_dt ) : d_dt;
+
+  while( d_t < d_t_end )
+  {
+
+    bool b_last = d_t + 1.01 * d_h >= d_t_end;
+
+    if( b_last ) d_h = d_t_end - d_t;
+
+    double d_t_new = b_last ? d_t_end : d_t + d_h;
+    size_t i_k = std::min( iOrder, nodes() );
+    size_t i_q = std::min( i_k, nodes() - 1 );
+
+    coefficients( i_k, d_t_new, alpha );
+    extrapolate( i_q, d_t_new, y_pred );
+
+    s.assign( y_pred.size(), 0. );
+    for( size_t j = 1; j <= i_k; j++ )
+    {
+      const vector_t& y_j = node( j - 1 ).y;
+      for( size_t i = 0; i < s.size(); i++ ) s[i] += alpha[j] * y_j[i];
+    }
+
+    //==========================================================================
+    // Newton iteration on alpha_0 y + s - f(y) = 0.
+    //==========================================================================
+
+    y_new = y_pred;
+
+    WnMatrix * p_matrix = compute_jacobian( y_new );
+    WnMatrix__addValueToDiagonals( p_matrix, alpha[0] );
+
+    bool b_converged = false;
+
+    for( size_t n = 0; n < I_NEWTON_MAX_ITER && !b_converged; n++ )
+    {
+      compute_rhs( y_new, f );
+      r.resize( f.size() );
+      for( size_t i = 0; i < f.size(); i++ )
+        r[i] = f[i] - alpha[0] * y_new[i] - s[i];
+      solve( p_matrix, r );
+      for( size_t i = 0; i < r.size(); i++ ) y_new[i] += r[i];
+      b_converged = error_norm( r, node( 0 ).y, y_new ) <= D_NEWTON_TOLERANCE;
+      iNewton++;
+    }
+
+    WnMatrix__free( p_matrix );
+
+    if( !b_converged )
+    {
+      iRejected++;
+      d_h *= D_STEP_FAIL_FACTOR;
+      if( d_h < D_STEP_MIN )
+      {
+        std::cerr << "BDF step size underflow." << std::endl;
+        exit( EXIT_FAILURE );
+      }
+      continue;
+    }
+
+    //==========================================================================
+    // Error test.
+    //==========================================================================
+
+    for( size_t i = 0; i < y_pred.size(); i++ )
+      y_pred[i] = y_new[i] - y_pred[i];
+
+    double d_error = error_norm( y_pred, node( 0 ).y, y_new ) / ( i_q + 2 );
+
+    if( d_error > 1 )
+    {
+      iRejected++;
+      d_h *=
+        std::max( D_STEP_MIN_FACTOR, eta( d_error, i_k, D_BDF_BIAS_SAME ) );
+      continue;
+    }
+
+    //==========================================================================
+    // Choose the order and step for the next step from the error estimates
+    // at neighboring orders.
+    //==========================================================================
+
+    double d_best = eta( d_error, i_k, D_BDF_BIAS_SAME );
+    size_t i_k_new = i_k;
+
+    if( ++iStepsAtOrder > i_k )
+    {
+
+      if( i_k > 1 )
+      {
+        extrapolate( i_k - 1, d_t_new, y_other );
+        for( size_t i = 0; i < y_other.size(); i++ )
+          y_other[i] = y_new[i] - y_other[i];
+        double d_eta =
+          eta(
+            error_norm( y_other, node( 0 ).y, y_new ) / ( i_k + 1 ),
+            i_k - 1,
+            D_BDF_BIAS_DOWN
+          );
+        if( d_eta > d_best )
+        {
+          d_best = d_eta;
+          i_k_new = i_k - 1;
+        }
+      }
+
+      if( i_k < iMaxOrder && nodes() >= i_k + 2 )
+      {
+        extrapolate( i_k + 1, d_t_new, y_other );
+        for( size_t i = 0; i < y_other.size(); i++ )
+          y_other[i] = y_new[i] - y_other[i];
+        double d_eta =
+          eta(
+            error_norm( y_other, node( 0 ).y, y_new ) / ( i_k + 3 ),
+            i_k + 1,
+            D_BDF_BIAS_UP
+          );
+        if( d_eta > d_best )
+        {
+          d_best = d_eta;
+          i_k_new = i_k + 1;
+        }
+      }
+
+    }
+
+    point p;
+    p.t = d_t_new;
+    p.y = y_new;
+    pending.push_back( p );
+
+    d_t = d_t_new;
+    iSteps++;
+    order_counts[i_k]++;
+
+    if( i_k_new != i_k )
+    {
+      iOrder = i_k_new;
+      iStepsAtOrder = 0;
+    }
+
+    d_h *= std::min( std::max( d_best, D_STEP_MIN_FACTOR ), D_STEP_MAX_FACTOR );
+
+  }
+
+  dH = d_h;
+
+  y = node( 0 ).y;
+
+}
+
+//##############################################################################
+// bdf_evolver::report().
+//##############################################################################
+
+void
+bdf_evolver::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nBDF evolver: %lu calls, %lu steps, %lu rejected, %lu Jacobians,"
+      " %lu Newton iterations\n"
+    ) % iCalls % iSteps % iRejected % iJacobians % iNewton;
+
+  os << "  steps by order:";
+
+  for( size_t i = 1; i < order_counts.size(); i++ )
+    os << boost::format( " %lu:%lu" ) % i % order_counts[i];
+
+  os << "\n\n";
+
+}
+
+//##############################################################################
+// rosenbrock_evolver::rosenbrock_evolver().
+//##############################################################################
+
+rosenbrock_evolver::rosenbrock_evolver(
+  nnt::Zone& _zone,
+  double d_rtol,
+  double d_atol,
+  bool b_dense
+) : network_evolver( _zone, d_rtol, d_atol ), bDense( b_dense )
+{}
+
+//##############################################################################
+// rosenbrock_evolver::use_zone_solver().  The arrow and iterative solvers are
+// only reachable through user::solve_matrix_for_zone().  The dense solver
+// overrides the zone's.
+//##############################################################################
+
+bool
+rosenbrock_evolver::use_zone_solver()
+{
+
+  if( bDense ) return false;
+
+  return
+    zone.hasProperty( S_ITERATIVE_SOLVER ) ||
+    (
+      zone.hasProperty( nnt::s_SOLVER ) &&
+      zone.getProperty<std::string>( nnt::s_SOLVER ) == nnt::s_ARROW
+    );
+
+}
+
+//##############################################################################
+// rosenbrock_evolver::integrate().  The stages are in the transformed form
+// (J + I / (h gamma)) k_i = f(y + sum_j a_ij k_j) + sum_j (c_ij / h) k_j,
+// with the RODAS3 coefficients of Sandu et al.  A stage whose point is the
+// same as the previous stage's reuses that function value.
+//##############################################################################
+
+void
+rosenbrock_evolver::integrate( vector_t& y, double d_dt )
+{
+
+  static const size_t i_stages = 4;
+  static const double d_gamma = 0.5;
+  static const double a[i_stages][i_stages] =
+    { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 2., 0, 0, 0 }, { 2., 0, 1., 0 } };
+  static const double c[i_stages][i_stages] =
+    {
+      { 0, 0, 0, 0 },
+      { 4., 0, 0, 0 },
+      { 1., -1., 0, 0 },
+      { 1., -1., -8. / 3., 0 }
+    };
+  static const bool new_f[i_stages] = { true, false, true, true };
+  static const double m[i_stages] = { 2., 0, 1., 1. };
+  static const double e[i_stages] = { 0, 0, 0, 1. };
+
+  std::vector<vector_t> k( i_stages );
+  vector_t f, y_stage( y.size() ), y_new( y.size() ), err( y.size() );
+  gsl_permutation * p_permutation = NULL;
+  int i_sign;
+
+  double d_t = 0;
+  double d_h = dH > 0 ? std::min( dH, d_dt ) : d_dt;
+
+  bool b_zone_solver = use_zone_solver();
+
+  if( !b_zone_solver ) p_permutation = gsl_permutation_alloc( y.size() );
+
+  while( d_t < d_dt )
+  {
+
+    bool b_last = d_t + 1.01 * d_h >= d_dt;
+
+    if( b_last ) d_h = d_dt - d_t;
+
+    WnMatrix * p_matrix = compute_jacobian( y );
+    WnMatrix__addValueToDiagonals( p_matrix, 1. / ( d_h * d_gamma ) );
+
+    gsl_matrix * p_lu = NULL;
+
+    if( !b_zone_solver )
+    {
+      p_lu = WnMatrix__getGslMatrix( p_matrix );
+      gsl_linalg_LU_decomp( p_lu, p_permutation, &i_sign );
+      iFactorizations++;
+    }
+
+    for( size_t s = 0; s < i_stages; s++ )
+    {
+
+      if( new_f[s] )
+      {
+        y_stage = y;
+        for( size_t j = 0; j < s; j++ )
+          for( size_t i = 0; i < y.size(); i++ )
+            y_stage[i] += a[s][j] * k[j][i];
+        compute_rhs( y_stage, f );
+      }
+
+      k[s] = f;
+      for( size_t j = 0; j < s; j++ )
+        for( size_t i = 0; i < y.size(); i++ )
+          k[s][i] += c[s][j] * k[j][i] / d_h;
+
+      if( b_zone_solver )
+        solve( p_matrix, k[s] );
+      else
+      {
+        gsl_vector_view view = gsl_vector_view_array( &k[s][0], k[s].size() );
+        gsl_linalg_LU_svx( p_lu, p_permutation, &view.vector );
+        iSolves++;
+      }
+
+    }
+
+    if( p_lu ) gsl_matrix_free( p_lu );
+    WnMatrix__free( p_matrix );
+
+    y_new = y;
+    err.assign( y.size(), 0. );
+    for( size_t s = 0; s < i_stages; s++ )
+    {
+      for( size_t i = 0; i < y.size(); i++ )
+      {
+        y_new[i] += m[s] * k[s][i];
+        err[i] += e[s] * k[s][i];
+      }
+    }
+
+    double d_error = error_norm( err, y, y_new );
+
+    double d_factor =
+      std::min(
+        std::max(
+          D_STEP_SAFETY * pow( std::max( d_error, 1.e-10 ), -1. / 3. ),
+          D_STEP_MIN_FACTOR
+        ),
+        D_STEP_MAX_FACTOR
+      );
+
+    if( d_error > 1 )
+    {
+      iRejected++;
+      d_h *= std::min( d_factor, 1. );
+      if( d_h < D_STEP_MIN )
+      {
+        std::cerr << "Rosenbrock step size underflow." << std::endl;
+        exit( EXIT_FAILURE );
+      }
+      continue;
+    }
+
+    y.swap( y_new );
+    d_t = b_last ? d_dt : d_t + d_h;
+    iSteps++;
+
+    d_h *= d_factor;
+
+  }
+
+  if( p_permutation ) gsl_permutation_free( p_permutation );
+
+  dH = d_h;
+
+}
+
+//##############################################################################
+// rosenbrock_evolver::report().
+//##############################################################################
+
+void
+rosenbrock_evolver::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nRosenbrock evolver: %lu calls, %lu steps, %lu rejected,"
+      " %.2f Jacobians, %.2f factorizations, and %.2f matrix solves per"
+      " step\n\n"
+    ) %
+    iCalls %
+    iSteps %
+    iRejected %
+    ( iSteps ? (double) iJacobians / iSteps : 0. ) %
+    ( iSteps ? (double) iFactorizations / iSteps : 0. ) %
+    ( iSteps ? (double) iSolves / iSteps : 0. );
+
+}
+
+//##############################################################################
+// jfnk_evolver::jfnk_evolver().
+//##############################################################################
+
+jfnk_evolver::jfnk_evolver(
+  nnt::Zone& _zone,
+  double d_rtol,
+  double d_atol,
+  const std::string& s_border
+) : network_evolver( _zone, d_rtol, d_atol ), iAge( 0 ), iRefreshes( 0 ),
+    iNewton( 0 ), iKrylov( 0 ), iProducts( 0 )
+{
+
+  std::istringstream names( s_border );
+  std::string s_name;
+
+  while( names >> s_name ) borderNames.push_back( s_name );
+
+}
+
+//##############################################################################
+// jfnk_evolver::refresh().  The diagonal and the border rows and columns of
+// -dYdot/dY from the flows of the evolution network's reactions.  Ydot_i
+// gets (n_i - m_i)(f - r) from each reaction, and f and r go as Y_j^m_j and
+// Y_j^n_j.  Border species not in the network are left out.
+//##############################################################################
+
+void
+jfnk_evolver::refresh( vector_t& y )
+{
+
+  typedef std::map<size_t, std::pair<int, int> > count_map_t;
+
+  count_map_t counts;
+
+  Libnucnet__Nuc * p_nuc =
+    Libnucnet__Net__getNuc( Libnucnet__Zone__getNet( zone.getNucnetZone() ) );
+
+  gsl_vector_view view = gsl_vector_view_array( &y[0], y.size() );
+
+  Libnucnet__Zone__updateAbundances( zone.getNucnetZone(), &view.vector );
+
+  diagonal.assign( y.size(), 0. );
+
+  border.clear();
+  slots.assign( y.size(), -1 );
+
+  for( size_t b = 0; b < borderNames.size(); b++ )
+  {
+    Libnucnet__Species * p_species =
+      Libnucnet__Nuc__getSpeciesByName( p_nuc, borderNames[b].c_str() );
+    if( !p_species ) continue;
+    slots[Libnucnet__Species__getIndex( p_species )] = (int) border.size();
+    border.push_back( Libnucnet__Species__getIndex( p_species ) );
+  }
+
+  rows.assign( border.size(), vector_t( y.size(), 0. ) );
+  columns.assign( border.size(), vector_t( y.size(), 0. ) );
+
+  nnt::reaction_list_t reaction_list =
+    nnt::make_reaction_list(
+      Libnucnet__Net__getReac(
+        Libnucnet__NetView__getNet( zone.getNetView( EVOLUTION_NETWORK ) )
+      )
+    );
+
+  BOOST_FOREACH( nnt::Reaction reaction, reaction_list )
+  {
+
+    counts.clear();
+
+    nnt::reaction_element_list_t reactant_list =
+      nnt::make_reaction_nuclide_reactant_list(
+        reaction.getNucnetReaction()
+      );
+
+    BOOST_FOREACH( nnt::ReactionElement element, reactant_list )
+    {
+      counts[species_index( p_nuc, element )].first++;
+    }
+
+    nnt::reaction_element_list_t product_list =
+      nnt::make_reaction_nuclide_product_list(
+        reaction.getNucnetReaction()
+      );
+
+    BOOST_FOREACH( nnt::ReactionElement element, product_list )
+    {
+      counts[species_index( p_nuc, element )].second++;
+    }
+
+    std::pair<double, double> flows =
+      user::compute_flows_for_reaction( zone, reaction.getNucnetReaction() );
+
+    for(
+      count_map_t::const_iterator it = counts.begin();
+      it != counts.end();
+      it++
+    )
+    {
+
+      int m = it->second.first, n = it->second.second;
+
+      if( m == n ) continue;
+
+      for(
+        count_map_t::const_iterator jt = counts.begin();
+        jt != counts.end();
+        jt++
+      )
+      {
+
+        if( y[jt->first] <= 0 ) continue;
+
+        double d_term =
+          ( m - n ) *
+          ( jt->second.first * flows.first - jt->second.second * flows.second )
+          / y[jt->first];
+
+        if( it->first == jt->first )
+          diagonal[it->first] += d_term;
+        else
+        {
+          if( slots[it->first] >= 0 )
+            rows[slots[it->first]][jt->first] += d_term;
+          if( slots[jt->first] >= 0 )
+            columns[slots[jt->first]][it->first] += d_term;
+        }
+
+      }
+
+    }
+
+  }
+
+  iAge = 0;
+  iRefreshes++;
+
+}
+
+//##############################################################################
+// jfnk_evolver::species_index().
+//##############################################################################
+
+size_t
+jfnk_evolver::species_index(
+  Libnucnet__Nuc * p_nuc,
+  nnt::ReactionElement& element
+)
+{
+
+  return
+    Libnucnet__Species__getIndex(
+      Libnucnet__Nuc__getSpeciesByName(
+        p_nuc,
+        Libnucnet__Reaction__Element__getName(
+          element.getNucnetReactionElement()
+        )
+      )
+    );
+
+}
+
+//##############################################################################
+// jfnk_evolver::inverse_diagonal().  The inverse of 1 / h + d_i, or h if that
+// is within D_JFNK_DIAGONAL_FLOOR of zero relative to 1 / h.
+//##############################################################################
+
+double
+jfnk_evolver::inverse_diagonal( size_t i, double d_h ) const
+{
+
+  double d_diagonal = 1. / d_h + diagonal[i];
+
+  if( fabs( d_diagonal ) < D_JFNK_DIAGONAL_FLOOR / d_h ) return d_h;
+
+  return 1. / d_diagonal;
+
+}
+
+//##############################################################################
+// jfnk_evolver::factor_border().  Inverts the Schur complement of the
+// preconditioner on the border, L - R D^-1 C, where L is the border block,
+// R and C the border rows and columns off it, and D the rest of the
+// diagonal.  A singular complement leaves the border on its diagonal.
+//##############################################################################
+
+void
+jfnk_evolver::factor_border( double d_h )
+{
+
+  size_t k = border.size();
+  int i_sign;
+
+  schurInverse.assign( k * k, 0. );
+
+  if( k == 0 ) return;
+
+  gsl_matrix * p_schur = gsl_matrix_alloc( k, k );
+  gsl_permutation * p_permutation = gsl_permutation_alloc( k );
+  gsl_vector * p_column = gsl_vector_alloc( k );
+  bool b_singular = false;
+
+  for( size_t b = 0; b < k; b++ )
+  {
+    for( size_t c = 0; c < k; c++ )
+    {
+      double d_sum =
+        b == c ? 1. / d_h + diagonal[border[b]] : rows[b][border[c]];
+      for( size_t i = 0; i < diagonal.size(); i++ )
+      {
+        if( slots[i] < 0 && rows[b][i] != 0 && columns[c][i] != 0 )
+          d_sum -= rows[b][i] * inverse_diagonal( i, d_h ) * columns[c][i];
+      }
+      gsl_matrix_set( p_schur, b, c, d_sum );
+    }
+  }
+
+  gsl_linalg_LU_decomp( p_schur, p_permutation, &i_sign );
+
+  for( size_t b = 0; b < k; b++ )
+  {
+    if(
+      fabs( gsl_matrix_get( p_schur, b, b ) ) < D_JFNK_DIAGONAL_FLOOR / d_h
+    )
+      b_singular = true;
+  }
+
+  for( size_t c = 0; c < k; c++ )
+  {
+
+    if( b_singular )
+    {
+      schurInverse[c * k + c] = inverse_diagonal( border[c], d_h );
+      continue;
+    }
+
+    for( size_t b = 0; b < k; b++ ) p_column->data[b] = b == c ? 1. : 0.;
+
+    gsl_linalg_LU_svx( p_schur, p_permutation, p_column );
+
+    for( size_t b = 0; b < k; b++ )
+      schurInverse[b * k + c] = p_column->data[b];
+
+  }
+
+  gsl_vector_free( p_column );
+  gsl_permutation_free( p_permutation );
+  gsl_matrix_free( p_schur );
+
+}
+
+//##############################################################################
+// jfnk_evolver::precondition().  Solves the arrow preconditioner for z: the
+// border from the Schur complement, then the rest from the diagonal.
+//##############################################################################
+
+void
+jfnk_evolver::precondition(
+  const vector_t& v,
+  double d_h,
+  vector_t& z
+) const
+{
+
+  size_t k = border.size();
+  vector_t u( k ), z_border( k, 0. );
+
+  z.resize( v.size() );
+
+  for( size_t i = 0; i < v.size(); i++ )
+    z[i] = v[i] * inverse_diagonal( i, d_h );
+
+  if( k == 0 ) return;
+
+  for( size_t b = 0; b < k; b++ )
+  {
+    u[b] = v[border[b]];
+    for( size_t i = 0; i < v.size(); i++ )
+      if( slots[i] < 0 ) u[b] -= rows[b][i] * z[i];
+  }
+
+  for( size_t b = 0; b < k; b++ )
+    for( size_t c = 0; c < k; c++ )
+      z_border[b] += schurInverse[b * k + c] * u[c];
+
+  for( size_t i = 0; i < v.size(); i++ )
+  {
+    if( slots[i] >= 0 )
+    {
+      z[i] = z_border[slots[i]];
+      continue;
+    }
+    double d_sum = 0;
+    for( size_t c = 0; c < k; c++ ) d_sum += columns[c][i] * z_border[c];
+    z[i] -= d_sum * inverse_diagonal( i, d_h );
+  }
+
+}
+
+//##############################################################################
+// jfnk_evolver::apply().  Computes (I / h - dYdot/dY) v from the flow
+// vector f at y.
+//##############################################################################
+
+void
+jfnk_evolver::apply(
+  const vector_t& y,
+  const vector_t& f,
+  const vector_t& v,
+  double d_h,
+  vector_t& w
+)
+{
+
+  double d_y_norm = 0, d_v_norm = 0;
+
+  for( size_t i = 0; i < y.size(); i++ )
+  {
+    d_y_norm += y[i] * y[i];
+    d_v_norm += v[i] * v[i];
+  }
+
+  w.assign( y.size(), 0. );
+
+  if( d_v_norm == 0 ) return;
+
+  double d_eps =
+    sqrt( GSL_DBL_EPSILON ) * ( 1. + sqrt( d_y_norm ) ) / sqrt( d_v_norm );
+
+  vector_t y_eps( y.size() ), f_eps;
+
+  for( size_t i = 0; i < y.size(); i++ ) y_eps[i] = y[i] + d_eps * v[i];
+
+  compute_rhs( y_eps, f_eps );
+
+  for( size_t i = 0; i < y.size(); i++ )
+    w[i] = v[i] / d_h - ( f_eps[i] - f[i] ) / d_eps;
+
+  iProducts++;
+
+}
+
+//##############################################################################
+// jfnk_evolver::gmres().  Right-preconditioned restarted GMRES for A x = b
+// with x starting at zero.  Returns false if the residual target is not
+// met.
+//##############################################################################
+
+bool
+jfnk_evolver::gmres(
+  const vector_t& y,
+  const vector_t& f,
+  const vector_t& b,
+  double d_h,
+  vector_t& x
+)
+{
+
+  size_t n = b.size(), m = I_GMRES_RESTART;
+  std::vector<vector_t> v( m + 1, vector_t( n ) );
+  std::vector<vector_t> hess( m + 1, vector_t( m, 0. ) );
+  vector_t cs( m ), sn( m ), g( m + 1 ), z( n ), w( n ), r( b );
+
+  double d_b_norm = 0;
+  for( size_t i = 0; i < n; i++ ) d_b_norm += b[i] * b[i];
+  d_b_norm = sqrt( d_b_norm );
+
+  x.assign( n, 0. );
+
+  if( d_b_norm == 0 ) return true;
+
+  factor_border( d_h );
+
+  for( size_t i_restart = 0; i_restart < I_GMRES_MAX_RESTARTS; i_restart++ )
+  {
+
+    double d_beta = 0;
+    for( size_t i = 0; i < n; i++ ) d_beta += r[i] * r[i];
+    d_beta = sqrt( d_beta );
+
+    if( d_beta <= D_GMRES_TOLERANCE * d_b_norm ) return true;
+
+    for( size_t i = 0; i < n; i++ ) v[0][i] = r[i] / d_beta;
+    g.assign( m + 1, 0. );
+    g[0] = d_beta;
+
+    size_t k = 0;
+
+    while( k < m )
+    {
+
+      precondition( v[k], d_h, z );
+
+      apply( y, f, z, d_h, w );
+      iKrylov++;
+
+      for( size_t j = 0; j <= k; j++ )
+      {
+        double d_dot = 0;
+        for( size_t i = 0; i < n; i++ ) d_dot += w[i] * v[j][i];
+        hess[j][k] = d_dot;
+        for( size_t i = 0; i < n; i++ ) w[i] -= d_dot * v[j][i];
+      }
+
+      double d_norm = 0;
+      for( size_t i = 0; i < n; i++ ) d_norm += w[i] * w[i];
+      hess[k + 1][k] = sqrt( d_norm );
+
+      if( hess[k + 1][k] > 0 )
+        for( size_t i = 0; i < n; i++ ) v[k + 1][i] = w[i] / hess[k + 1][k];
+
+      for( size_t j = 0; j < k; j++ )
+      {
+        double d_tmp = cs[j] * hess[j][k] + sn[j] * hess[j + 1][k];
+        hess[j + 1][k] = -sn[j] * hess[j][k] + cs[j] * hess[j + 1][k];
+        hess[j][k] = d_tmp;
+      }
+
+      double d_r = hypot( hess[k][k], hess[k + 1][k] );
+      cs[k] = hess[k][k] / d_r;
+      sn[k] = hess[k + 1][k] / d_r;
+      hess[k][k] = d_r;
+      hess[k + 1][k] = 0;
+      g[k + 1] = -sn[k] * g[k];
+      g[k] *= cs[k];
+
+      k++;
+
+      if( fabs( g[k] ) <= D_GMRES_TOLERANCE * d_b_norm ) break;
+
+    }
+
+    //==========================================================================
+    // Update x with the preconditioned combination of the Krylov vectors.
+    //==========================================================================
+
+    vector_t c( k );
+
+    for( size_t j = k; j-- > 0; )
+    {
+      double d_sum = g[j];
+      for( size_t l = j + 1; l < k; l++ ) d_sum -= hess[j][l] * c[l];
+      c[j] = d_sum / hess[j][j];
+    }
+
+    w.assign( n, 0. );
+    for( size_t j = 0; j < k; j++ )
+      for( size_t i = 0; i < n; i++ ) w[i] += c[j] * v[j][i];
+
+    precondition( w, d_h, z );
+
+    for( size_t i = 0; i < n; i++ ) x[i] += z[i];
+
+    apply( y, f, x, d_h, w );
+    for( size_t i = 0; i < n; i++ ) r[i] = b[i] - w[i];
+
+  }
+
+  double d_r_norm = 0;
+  for( size_t i = 0; i < n; i++ ) d_r_norm += r[i] * r[i];
+
+  return sqrt( d_r_norm ) <= D_GMRES_TOLERANCE * d_b_norm;
+
+}
+
+//##############################################################################
+// jfnk_evolver::step().  A backward Euler step of size h from y0.
+//##############################################################################
+
+bool
+jfnk_evolver::step( vector_t& y, const vector_t& y0, double d_h )
+{
+
+  vector_t f, r( y.size() ), dy;
+
+  for( size_t n = 0; n < I_JFNK_MAX_NEWTON; n++ )
+  {
+
+    compute_rhs( y, f );
+
+    for( size_t i = 0; i < y.size(); i++ )
+      r[i] = f[i] - ( y[i] - y0[i] ) / d_h;
+
+    if( !gmres( y, f, r, d_h, dy ) ) return false;
+
+    for( size_t i = 0; i < y.size(); i++ ) y[i] += dy[i];
+
+    iNewton++;
+
+    if( error_norm( dy, y0, y ) <= D_NEWTON_TOLERANCE ) return true;
+
+  }
+
+  return false;
+
+}
+
+//##############################################################################
+// jfnk_evolver::integrate().
+//##############################################################################
+
+void
+jfnk_evolver::integrate( vector_t& y, double d_dt )
+{
+
+  double d_t = 0, d_h = d_dt;
+  bool b_fresh = false;
+
+  while( d_t < d_dt )
+  {
+
+    if( diagonal.size() != y.size() || iAge >= I_JFNK_PRECONDITIONER_AGE )
+    {
+      refresh( y );
+      b_fresh = true;
+    }
+
+    bool b_last = d_t + 1.01 * d_h >= d_dt;
+
+    if( b_last ) d_h = d_dt - d_t;
+
+    vector_t y_new( y );
+
+    if( step( y_new, y, d_h ) )
+    {
+      y.swap( y_new );
+      d_t = b_last ? d_dt : d_t + d_h;
+      iSteps++;
+      iAge++;
+      b_fresh = false;
+      continue;
+    }
+
+    iRejected++;
+
+    if( !b_fresh )
+    {
+      refresh( y );
+      b_fresh = true;
+      continue;
+    }
+
+    d_h *= 0.5;
+
+    if( d_h < D_STEP_MIN )
+    {
+      std::cerr << "JFNK step size underflow." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+
+  }
+
+}
+
+//##############################################################################
+// jfnk_evolver::report().
+//##############################################################################
+
+void
+jfnk_evolver::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nJFNK evolver: %lu calls, %lu steps, %lu failed, %lu Newton"
+      " iterations, %lu Krylov iterations, %lu Jacobian-vector products,"
+      " %lu preconditioner refreshes\n\n"
+    ) %
+    iCalls % iSteps % iRejected % iNewton % iKrylov % iProducts % iRefreshes;
+
+}
+
+}  // namespace my_user
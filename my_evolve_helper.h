@@ -0,0 +1,305 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_evolve_helper.h
+//! \brief A header file to define network evolution helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_EVOLVE_HELPER_H
+#define MY_EVOLVE_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_permutation.h>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "user/evolve.h"
+#include "user/flow_utilities.h"
+
+#define S_EVOLVER          "evolver"
+#define S_EVOLVER_DEFAULT  "default"
+#define S_EVOLVER_BDF      "bdf"
+#define S_EVOLVER_ROSENBROCK "rosenbrock"
+#define S_EVOLVER_JFNK     "jfnk"
+#define S_EVOLVER_RTOL     "evolver_rtol"
+#define S_EVOLVER_ATOL     "evolver_atol"
+#define S_BDF_MAX_ORDER    "bdf_max_order"
+#define S_ROSENBROCK_SOLVER "rosenbrock_solver"
+#define S_ROSENBROCK_ZONE  "zone"
+#define S_ROSENBROCK_DENSE "dense"
+#define S_ITERATIVE_SOLVER "iterative solver method"
+
+#define I_BDF_MAX_ORDER      5     /* Highest BDF order */
+#define I_NEWTON_MAX_ITER    4     /* Newton iterations before a step fails */
+#define D_NEWTON_TOLERANCE   0.1   /* Weighted Newton correction for success */
+#define D_STEP_MIN_FACTOR    0.2   /* Smallest step change factor */
+#define D_STEP_MAX_FACTOR    10.   /* Largest step change factor */
+#define D_STEP_FAIL_FACTOR   0.25  /* Step factor after a Newton failure */
+#define D_STEP_MIN           1.e-30 /* Smallest internal step (s) */
+#define D_BDF_BIAS_DOWN      6.    /* Error bias for an order decrease */
+#define D_BDF_BIAS_SAME      6.    /* Error bias for the same order */
+#define D_BDF_BIAS_UP        10.   /* Error bias for an order increase */
+#define D_STEP_SAFETY        0.9   /* Safety factor for one-step methods */
+#define I_GMRES_RESTART      30    /* Krylov vectors before a GMRES restart */
+#define I_GMRES_MAX_RESTARTS 5     /* GMRES restarts before a failure */
+#define D_GMRES_TOLERANCE    1.e-3 /* GMRES relative residual target */
+#define I_JFNK_MAX_NEWTON    8     /* Newton iterations for the JFNK step */
+#define I_JFNK_PRECONDITIONER_AGE  20 /* Steps between diagonal refreshes */
+#define D_JFNK_DIAGONAL_FLOOR 1.e-8 /* Smallest |1 + h d| kept in the diagonal */
+#define S_JFNK_BORDER      "n h1 he4" /* Light species of the JFNK border */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// network_evolver.
+//##############################################################################
+
+/**
+ * @brief A base class for network evolvers that fit the evolution function
+ *        slot.
+ *
+ * The rates are computed once per call at the zone's T9 and rho, which stay
+ * fixed over the step as they do for the default evolver.  The abundance
+ * derivatives come from Libnucnet__Zone__computeFlowVector() and the
+ * Jacobian from Libnucnet__Zone__computeJacobian(), which returns
+ * -dYdot/dY, so that the implicit matrix is J + a I.  Errors are measured in
+ * the max norm with weights rtol * |Y| + atol.  After a call, the zone holds
+ * the new abundances and the abundance changes over the step, and
+ * suggestedStep() returns the evolver's choice for the next step.  The
+ * zone routines act on the zone's evolution network, so the view passed to
+ * a call must be that view; any other is an error.
+ */
+
+class network_evolver
+{
+
+  public:
+    network_evolver( nnt::Zone&, double, double );
+    virtual ~network_evolver() {}
+
+    void operator()( Libnucnet__NetView *, const double );
+    double suggestedStep() const { return dH; }
+    virtual void report( std::ostream& ) const = 0;
+
+  protected:
+    typedef std::vector<double> vector_t;
+
+    nnt::Zone& zone;
+    double dRtol, dAtol, dH;
+    size_t iCalls, iSteps, iRejected, iJacobians, iFactorizations, iSolves;
+
+    virtual void integrate( vector_t&, double ) = 0;
+
+    void compute_rhs( vector_t&, vector_t& );
+    WnMatrix * compute_jacobian( vector_t& );
+    void solve( WnMatrix *, vector_t& );
+    double error_norm(
+      const vector_t&, const vector_t&, const vector_t&
+    ) const;
+
+};
+
+//##############################################################################
+// bdf_evolver.
+//##############################################################################
+
+/**
+ * @brief A variable-step, variable-order (1 to 5) BDF network evolver.
+ *
+ * The BDF coefficients are the derivatives at the new time of the Lagrange
+ * basis through the new and past points, so uneven steps need no
+ * interpolation.  The local error at order q is estimated from the
+ * difference between the corrector and the order q extrapolation of the
+ * past points.  After q + 1 steps at an order, the order that allows the
+ * largest next step is chosen.
+ *
+ * The driver also calls the evolution function for trial steps whose
+ * abundances it then restores.  The points of each call are therefore kept
+ * as pending and only join the history when a later call starts from the
+ * abundances the call ended with.  A call that starts anywhere else resets
+ * the history and the order.
+ */
+
+class bdf_evolver : public network_evolver
+{
+
+  public:
+    bdf_evolver( nnt::Zone&, double, double, size_t );
+
+    void report( std::ostream& ) const;
+
+  private:
+    struct point
+    {
+      double t;
+      vector_t y;
+    };
+
+    size_t iMaxOrder, iOrder, iStepsAtOrder, iNewton;
+    std::deque<point> history;
+    std::vector<point> pending;
+    std::vector<size_t> order_counts;
+
+    void integrate( vector_t&, double );
+    void start( const vector_t& );
+    const point& node( size_t ) const;
+    size_t nodes() const;
+    void extrapolate( size_t, double, vector_t& ) const;
+    void coefficients( size_t, double, std::vector<double>& ) const;
+    double eta( double, size_t, double ) const;
+
+};
+
+//##############################################################################
+// rosenbrock_evolver.
+//##############################################################################
+
+/**
+ * @brief A RODAS3 Rosenbrock-W network evolver.
+ *
+ * RODAS3 is a four-stage, third-order, stiffly accurate, L-stable linearly
+ * implicit method with an embedded second-order solution for the step
+ * error.  Each step forms the Jacobian once and needs no Newton iteration.
+ * All stages use the matrix J + I / (h gamma).  With the zone's solver,
+ * which the driver sets to arrow, each of the four stage solves goes
+ * through user::solve_matrix_for_zone(), which keeps no factorization
+ * between calls, so the matrix is factored four times per step.  With the
+ * dense solver, the matrix is copied to a full gsl matrix and LU factored
+ * once per step, and each stage is a back substitution.  That copy holds
+ * n^2 doubles for n species and the factorization costs O(n^3), so the
+ * dense solver only pays off for small networks.  The report gives
+ * Jacobians, factorizations, and solves per step for comparison with the
+ * default evolver, which factors once per Newton iteration.
+ */
+
+class rosenbrock_evolver : public network_evolver
+{
+
+  public:
+    rosenbrock_evolver( nnt::Zone&, double, double, bool = false );
+
+    void report( std::ostream& ) const;
+
+  private:
+    bool bDense;
+
+    void integrate( vector_t&, double );
+    bool use_zone_solver();
+
+};
+
+//##############################################################################
+// jfnk_evolver.
+//##############################################################################
+
+/**
+ * @brief A Jacobian-free Newton-Krylov network evolver.
+ *
+ * Each step is a backward Euler step like that of the default evolver, but
+ * the Newton corrections come from restarted GMRES.  Jacobian-vector
+ * products are differences of flow vectors, so no matrix is kept.  GMRES is
+ * right preconditioned by an arrow approximation of the implicit matrix:
+ * its diagonal, plus the full rows and columns of the border species, the
+ * light particles (S_JFNK_BORDER for the driver) that couple to most of
+ * the network.  The entries are built from the reactions' flows, with no
+ * Jacobian: a reaction with forward and reverse flows f and r, in which
+ * species i appears m_i times as a reactant and n_i times as a product,
+ * adds (m_i - n_i)(m_j f - n_j r) / Y_j to entry (i, j).  Species with zero
+ * abundance get no reaction term.  The preconditioner is solved through the
+ * Schur complement on the border, so its cost is linear in the network size.
+ * A diagonal entry 1 / h + d near zero, which a dominant reverse flow can
+ * give, falls back to 1 / h.  The entries are rebuilt after
+ * I_JFNK_PRECONDITIONER_AGE accepted steps, or sooner if a solve fails.  A
+ * step that fails is split in two.
+ */
+
+class jfnk_evolver : public network_evolver
+{
+
+  public:
+    jfnk_evolver( nnt::Zone&, double, double, const std::string& = "" );
+
+    void report( std::ostream& ) const;
+
+  private:
+    std::vector<std::string> borderNames;
+    std::vector<size_t> border;
+    std::vector<int> slots;
+    std::vector<vector_t> rows, columns;
+    vector_t diagonal, schurInverse;
+    size_t iAge, iRefreshes, iNewton, iKrylov, iProducts;
+
+    void integrate( vector_t&, double );
+    bool step( vector_t&, const vector_t&, double );
+    void refresh( vector_t& );
+    size_t species_index( Libnucnet__Nuc *, nnt::ReactionElement& );
+    double inverse_diagonal( size_t, double ) const;
+    void factor_border( double );
+    void precondition( const vector_t&, double, vector_t& ) const;
+    void apply(
+      const vector_t&, const vector_t&, const vector_t&, double, vector_t&
+    );
+    bool gmres(
+      const vector_t&, const vector_t&, const vector_t&, double, vector_t&
+    );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_evolve_descriptions( po::options_description& );
+
+void
+set_evolve_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_EVOLVE_HELPER_H
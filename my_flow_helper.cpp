@@ -0,0 +1,688 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_flow_helper.cpp
+//! \brief A file to define reaction flow and entropy generation diagnostic
+//!        routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_flow_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_flow_descriptions().
+//##############################################################################
+
+void
+get_flow_descriptions( po::options_description& flow )
+{
+
+  try
+  {
+
+    flow.add_options()
+
+      ( S_FLOW_OUTPUT,
+        po::value<std::string>(),
+        "File for time-integrated reaction flows and entropy generation"
+        " (default: none)"
+      )
+
+      ( S_SDOT_TOP_K,
+        po::value<size_t>()->default_value( 0 ),
+        "Number of top entropy-generating reactions to track and report"
+        " (0 = none)"
+      )
+
+      ( S_SDOT_TOLERANCE,
+        po::value<double>()->default_value( 0., "0." ),
+        "Fraction of sdot the adaptive reduced sdot view may leave out"
+        " (0 = always use the full sdot view)"
+      )
+
+      ( S_SDOT_CHECK_INTERVAL,
+        po::value<size_t>()->default_value( 50 ),
+        "Entropy generation calls between full sdot checks"
+      )
+
+      ( S_SDOT_CHECK_THRESHOLD,
+        po::value<double>()->default_value( 0.01, "0.01" ),
+        "Relative t9 or rho change that forces a full sdot check"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_flow_options().
+//##############################################################################
+
+void
+set_flow_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  if( vmap.count( S_FLOW_OUTPUT ) )
+    param_map[S_FLOW_OUTPUT] = vmap[S_FLOW_OUTPUT].as<std::string>();
+
+  param_map[S_SDOT_TOP_K] = vmap[S_SDOT_TOP_K].as<size_t>();
+  param_map[S_SDOT_TOLERANCE] = vmap[S_SDOT_TOLERANCE].as<double>();
+  param_map[S_SDOT_CHECK_INTERVAL] = vmap[S_SDOT_CHECK_INTERVAL].as<size_t>();
+  param_map[S_SDOT_CHECK_THRESHOLD] =
+    vmap[S_SDOT_CHECK_THRESHOLD].as<double>();
+
+  if(
+    boost::any_cast<double>( param_map[S_SDOT_TOLERANCE] ) < 0 ||
+    boost::any_cast<double>( param_map[S_SDOT_TOLERANCE] ) >= 1
+  )
+  {
+    std::cerr << "sdot tolerance must be in [0, 1)." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// compute_reaction_sdot().  The entropy generation rate per nucleon (in
+// units of Boltzmann's constant) for a reaction with the input forward and
+// reverse flows is (f - r) ln( f / r ).  One-way reactions give zero.
+//##############################################################################
+
+double
+compute_reaction_sdot( const std::pair<double, double>& flows )
+{
+
+  if( flows.first <= 0 || flows.second <= 0 ) return 0;
+
+  return
+    ( flows.first - flows.second ) * log( flows.first / flows.second );
+
+}
+
+//##############################################################################
+// compute_sdot_contributions().  Fills the (reaction index, sdot) pairs for
+// the reactions in the view and returns their sum.
+//##############################################################################
+
+double
+compute_sdot_contributions(
+  nnt::Zone& zone,
+  Libnucnet__NetView * p_view,
+  const reaction_index& index,
+  std::vector<std::pair<size_t, double> >& contributions
+)
+{
+
+  double d_total = 0;
+
+  contributions.clear();
+
+  nnt::reaction_list_t reaction_list =
+    nnt::make_reaction_list(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_view ) )
+    );
+
+  BOOST_FOREACH( nnt::Reaction reaction, reaction_list )
+  {
+
+    size_t i = index.find( reaction.getNucnetReaction() );
+
+    if( i == index.size() ) continue;
+
+    double d_sdot =
+      compute_reaction_sdot(
+        user::compute_flows_for_reaction( zone, reaction.getNucnetReaction() )
+      );
+
+    contributions.push_back( std::make_pair( i, d_sdot ) );
+
+    d_total += d_sdot;
+
+  }
+
+  return d_total;
+
+}
+
+//##############################################################################
+// reaction_index::reaction_index().
+//##############################################################################
+
+reaction_index::reaction_index( Libnucnet__Net * p_net )
+{
+
+  nnt::reaction_list_t reaction_list =
+    nnt::make_reaction_list( Libnucnet__Net__getReac( p_net ) );
+
+  BOOST_FOREACH( nnt::Reaction reaction, reaction_list )
+  {
+    pointer_map[reaction.getNucnetReaction()] = reactions.size();
+    string_map[Libnucnet__Reaction__getString( reaction.getNucnetReaction() )] =
+      reactions.size();
+    reactions.push_back( reaction.getNucnetReaction() );
+  }
+
+}
+
+//##############################################################################
+// reaction_index::find().  Views normally share the parent's reactions, so
+// the pointer lookup succeeds; the string lookup is a fallback.
+//##############################################################################
+
+size_t
+reaction_index::find( Libnucnet__Reaction * p_reaction ) const
+{
+
+  std::map<const Libnucnet__Reaction *, size_t>::const_iterator it =
+    pointer_map.find( p_reaction );
+
+  if( it != pointer_map.end() ) return it->second;
+
+  std::map<std::string, size_t>::const_iterator its =
+    string_map.find( Libnucnet__Reaction__getString( p_reaction ) );
+
+  if( its != string_map.end() ) return its->second;
+
+  return reactions.size();
+
+}
+
+//##############################################################################
+// step_flows::step_flows().
+//##############################################################################
+
+step_flows::step_flows( const reaction_index& _index ) :
+  index( _index ), bPrevious( false ), bCurrent( false ), dSdotTotal( 0 ),
+  net_flows( _index.size(), 0. ), previous_net( _index.size(), 0. ),
+  reaction_sdot( _index.size(), 0. ), previous_sdot( _index.size(), 0. ),
+  flows( _index.size() ), in_evolution( _index.size(), false )
+{}
+
+//##############################################################################
+// step_flows::update().  Call after a step's final evolution so that the
+// zone's rates and abundances are those of the accepted step.
+//##############################################################################
+
+void
+step_flows::update(
+  nnt::Zone& zone,
+  Libnucnet__NetView * p_evolution_view,
+  Libnucnet__NetView * p_sdot_view
+)
+{
+
+  bPrevious = bCurrent;
+  bCurrent = true;
+
+  net_flows.swap( previous_net );
+  reaction_sdot.swap( previous_sdot );
+
+  std::fill( net_flows.begin(), net_flows.end(), 0. );
+  std::fill( reaction_sdot.begin(), reaction_sdot.end(), 0. );
+  std::fill( in_evolution.begin(), in_evolution.end(), false );
+
+  sdot_contributions.clear();
+  dSdotTotal = 0;
+
+  nnt::reaction_list_t reaction_list =
+    nnt::make_reaction_list(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_evolution_view ) )
+    );
+
+  BOOST_FOREACH( nnt::Reaction reaction, reaction_list )
+  {
+
+    size_t i = index.find( reaction.getNucnetReaction() );
+
+    if( i == index.size() ) continue;
+
+    flows[i] =
+      user::compute_flows_for_reaction( zone, reaction.getNucnetReaction() );
+
+    in_evolution[i] = true;
+
+    net_flows[i] = flows[i].first - flows[i].second;
+
+  }
+
+  nnt::reaction_list_t sdot_reaction_list =
+    nnt::make_reaction_list(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_sdot_view ) )
+    );
+
+  BOOST_FOREACH( nnt::Reaction reaction, sdot_reaction_list )
+  {
+
+    size_t i = index.find( reaction.getNucnetReaction() );
+
+    if( i == index.size() ) continue;
+
+    double d_sdot =
+      compute_reaction_sdot(
+        in_evolution[i] ?
+          flows[i] :
+          user::compute_flows_for_reaction( zone, reaction.getNucnetReaction() )
+      );
+
+    reaction_sdot[i] = d_sdot;
+    sdot_contributions.push_back( std::make_pair( i, d_sdot ) );
+    dSdotTotal += d_sdot;
+
+  }
+
+}
+
+//##############################################################################
+// flow_accumulator::flow_accumulator().
+//##############################################################################
+
+flow_accumulator::flow_accumulator( const reaction_index& _index ) :
+  index( _index ),
+  net_flows( _index.size(), 0. ),
+  entropy_generation( _index.size(), 0. )
+{}
+
+//##############################################################################
+// flow_accumulator::accumulate().  Call after step_flows::update() for the
+// accepted step of length d_dt.
+//##############################################################################
+
+void
+flow_accumulator::accumulate( const step_flows& flows, double d_dt )
+{
+
+  double d_start = flows.hasPrevious() ? 0.5 * d_dt : 0;
+  double d_end = d_dt - d_start;
+
+  for( size_t i = 0; i < index.size(); i++ )
+  {
+    net_flows[i] +=
+      d_start * flows.previousNet()[i] + d_end * flows.net()[i];
+    entropy_generation[i] +=
+      d_start * flows.previousSdot()[i] + d_end * flows.sdot()[i];
+  }
+
+}
+
+//##############################################################################
+// flow_accumulator::write().
+//##############################################################################
+
+void
+flow_accumulator::write( const std::string& s_file )
+{
+
+  output_stream stream( s_file, 0 );
+  std::string s_buffer;
+  char s_number[I_FORMAT_BUFFER_SIZE];
+
+  s_buffer = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  s_buffer += "<integrated_flows>\n";
+
+  for( size_t i = 0; i < index.size(); i++ )
+  {
+
+    if( net_flows[i] == 0 && entropy_generation[i] == 0 ) continue;
+
+    s_buffer += "  <reaction string=\"";
+    s_buffer +=
+      xml_escape( Libnucnet__Reaction__getString( index.reaction( i ) ) );
+    s_buffer += "\">\n    <net_flow>";
+    format_double( s_number, net_flows[i] );
+    s_buffer += s_number;
+    s_buffer += "</net_flow>\n    <entropy_generation>";
+    format_double( s_number, entropy_generation[i] );
+    s_buffer += s_number;
+    s_buffer += "</entropy_generation>\n  </reaction>\n";
+
+  }
+
+  s_buffer += "</integrated_flows>\n";
+
+  stream.write( s_buffer );
+  stream.close();
+
+}
+
+//##############################################################################
+// sdot_breakdown::sdot_breakdown().
+//##############################################################################
+
+sdot_breakdown::sdot_breakdown( const reaction_index& _index, size_t i_k ) :
+  index( _index ), iK( i_k ), iSteps( 0 ), dMinFraction( 1. ),
+  dTimeMinFraction( 0 ), dSumFraction( 0 ), dTime( 0 ),
+  dRunFull( 0 ), dRunUnattributed( 0 ),
+  run_sdot( _index.size(), 0. ), top_counts( _index.size(), 0 )
+{}
+
+//##############################################################################
+// sdot_breakdown::update().  Call after step_flows::update() with the same
+// sdot view.  Fractions are measured against the full rate from
+// user::compute_entropy_generation_rate(); whatever the per-reaction terms
+// miss (one-way reactions such as weak decays) is the unattributed
+// remainder.
+//##############################################################################
+
+void
+sdot_breakdown::update(
+  nnt::Zone& zone,
+  Libnucnet__NetView * p_sdot_view,
+  const step_flows& flows,
+  double d_dt
+)
+{
+
+  heap_t heap;
+  double d_full, d_total, d_top = 0, d_fraction;
+  const std::vector<std::pair<size_t, double> >& contributions =
+    flows.contributions();
+
+  d_full = user::compute_entropy_generation_rate( zone, p_sdot_view );
+
+  d_total = flows.sdotTotal();
+
+  dRunFull += d_full * d_dt;
+  dRunUnattributed += ( d_full - d_total ) * d_dt;
+
+  for( size_t j = 0; j < contributions.size(); j++ )
+  {
+
+    run_sdot[contributions[j].first] += contributions[j].second * d_dt;
+
+    if( heap.size() < iK )
+      heap.push(
+        entry_t( contributions[j].second, contributions[j].first )
+      );
+    else if( contributions[j].second > heap.top().first )
+    {
+      heap.pop();
+      heap.push(
+        entry_t( contributions[j].second, contributions[j].first )
+      );
+    }
+
+  }
+
+  while( !heap.empty() )
+  {
+    d_top += heap.top().first;
+    top_counts[heap.top().second]++;
+    heap.pop();
+  }
+
+  d_fraction = d_full > 0 ? d_top / d_full : 1.;
+
+  dTime = zone.getProperty<double>( nnt::s_TIME );
+
+  if( d_fraction < dMinFraction )
+  {
+    dMinFraction = d_fraction;
+    dTimeMinFraction = dTime;
+  }
+
+  dSumFraction += d_fraction;
+  iSteps++;
+
+}
+
+//##############################################################################
+// sdot_breakdown::report().
+//##############################################################################
+
+void
+sdot_breakdown::report( std::ostream& os ) const
+{
+
+  std::vector<entry_t> run_entries;
+  double d_run_total = dRunFull, d_cumulative = 0;
+  size_t i_union = 0;
+
+  for( size_t i = 0; i < index.size(); i++ )
+  {
+    if( run_sdot[i] > 0 ) run_entries.push_back( entry_t( run_sdot[i], i ) );
+    if( top_counts[i] > 0 ) i_union++;
+  }
+
+  std::partial_sort(
+    run_entries.begin(),
+    run_entries.begin() + std::min( iK, run_entries.size() ),
+    run_entries.end(),
+    std::greater<entry_t>()
+  );
+
+  os <<
+    boost::format(
+      "\nTop %lu entropy-generating reactions (%lu steps):\n"
+      "  step fraction of sdot explained: min = %.5e (t = %.5e),"
+      " mean = %.5e\n"
+      "  reactions ever in a step's top %lu: %lu\n"
+      "  unattributed (one-way reactions): %.5e (fraction %.5e)\n\n"
+    ) %
+    iK %
+    iSteps %
+    dMinFraction %
+    dTimeMinFraction %
+    ( iSteps ? dSumFraction / iSteps : 1. ) %
+    iK %
+    i_union %
+    dRunUnattributed %
+    ( d_run_total != 0 ? dRunUnattributed / d_run_total : 0. );
+
+  for( size_t j = 0; j < std::min( iK, run_entries.size() ); j++ )
+  {
+    d_cumulative += run_entries[j].first;
+    os <<
+      boost::format( "  %-40s %.5e %.5e %.5e\n" ) %
+      Libnucnet__Reaction__getString(
+        index.reaction( run_entries[j].second )
+      ) %
+      run_entries[j].first %
+      ( d_run_total != 0 ? run_entries[j].first / d_run_total : 0. ) %
+      ( d_run_total != 0 ? d_cumulative / d_run_total : 0. );
+  }
+
+  os << std::endl;
+
+}
+
+//##############################################################################
+// adaptive_sdot::adaptive_sdot().
+//##############################################################################
+
+adaptive_sdot::adaptive_sdot(
+  const reaction_index& _index,
+  double d_tolerance,
+  size_t i_interval,
+  double d_threshold,
+  const boost::function<size_t( )>& view_generation
+) : index( _index ), dTolerance( d_tolerance ), iInterval( i_interval ),
+    dThreshold( d_threshold ), iCalls( 0 ), iFullChecks( 0 ),
+    iReducedCalls( 0 ), iReducedSize( 0 ), iGenerationCheck( 0 ),
+    dT9Check( 0 ), dRhoCheck( 0 ), dScale( 1. ), dFull( 0 ),
+    dMaxError( 0 ), bReduced( false ), viewGeneration( view_generation )
+{}
+
+//##############################################################################
+// adaptive_sdot::compute_reduced_sum().
+//##############################################################################
+
+double
+adaptive_sdot::compute_reduced_sum( nnt::Zone& zone ) const
+{
+
+  double d_sum = 0;
+
+  for( size_t i = 0; i < reduced_reactions.size(); i++ )
+  {
+    d_sum +=
+      compute_reaction_sdot(
+        user::compute_flows_for_reaction( zone, reduced_reactions[i] )
+      );
+  }
+
+  return d_sum;
+
+}
+
+//##############################################################################
+// adaptive_sdot::full_check().  If the reduced sum vanishes it cannot be
+// rescaled, so the full rate is returned until the next check.
+//##############################################################################
+
+double
+adaptive_sdot::full_check( nnt::Zone& zone, Libnucnet__NetView * p_view )
+{
+
+  double d_full, d_total, d_reduced = 0, d_error;
+
+  d_full = user::compute_entropy_generation_rate( zone, p_view );
+
+  if( iFullChecks++ > 0 && d_full != 0 )
+  {
+    d_error =
+      fabs( dScale * compute_reduced_sum( zone ) - d_full ) / fabs( d_full );
+    if( d_error > dMaxError ) dMaxError = d_error;
+    if( log_enabled( LOG_INFO ) )
+    {
+      log_message(
+        LOG_INFO,
+        boost::str(
+          boost::format(
+            "sdot check %lu: reduced view of %lu reactions had relative"
+            " error %.5e (tolerance %.5e)"
+          ) % iFullChecks % reduced_reactions.size() % d_error % dTolerance
+        )
+      );
+    }
+  }
+
+  d_total = compute_sdot_contributions( zone, p_view, index, contributions );
+
+  entries.clear();
+  for( size_t j = 0; j < contributions.size(); j++ )
+  {
+    entries.push_back(
+      entry_t( fabs( contributions[j].second ), contributions[j].first )
+    );
+  }
+
+  std::sort( entries.begin(), entries.end(), std::greater<entry_t>() );
+
+  reduced_reactions.clear();
+  for( size_t j = 0; j < entries.size(); j++ )
+  {
+    if( d_reduced >= ( 1. - dTolerance ) * fabs( d_total ) ) break;
+    d_reduced += entries[j].first;
+    reduced_reactions.push_back( index.reaction( entries[j].second ) );
+  }
+
+  iReducedSize += reduced_reactions.size();
+
+  d_reduced = compute_reduced_sum( zone );
+  bReduced = d_reduced != 0;
+  dScale = bReduced ? d_full / d_reduced : 1.;
+  dFull = d_full;
+
+  iCalls = 0;
+  dT9Check = zone.getProperty<double>( nnt::s_T9 );
+  dRhoCheck = zone.getProperty<double>( nnt::s_RHO );
+  iGenerationCheck = viewGeneration();
+
+  return d_full;
+
+}
+
+//##############################################################################
+// adaptive_sdot::operator()().
+//##############################################################################
+
+double
+adaptive_sdot::operator()( nnt::Zone& zone, Libnucnet__NetView * p_view )
+{
+
+  if(
+    iFullChecks == 0 ||
+    viewGeneration() != iGenerationCheck ||
+    ++iCalls >= iInterval ||
+    fabs( zone.getProperty<double>( nnt::s_T9 ) - dT9Check ) >
+      dThreshold * dT9Check ||
+    fabs( zone.getProperty<double>( nnt::s_RHO ) - dRhoCheck ) >
+      dThreshold * dRhoCheck
+  )
+    return full_check( zone, p_view );
+
+  iReducedCalls++;
+
+  if( !bReduced ) return dFull;
+
+  return dScale * compute_reduced_sum( zone );
+
+}
+
+//##############################################################################
+// adaptive_sdot::report().
+//##############################################################################
+
+void
+adaptive_sdot::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nAdaptive sdot view: %lu full checks, %lu reduced evaluations,"
+      " mean reduced size %.1f of %lu reactions,"
+      " max measured relative error %.5e (tolerance %.5e)\n\n"
+    ) %
+    iFullChecks %
+    iReducedCalls %
+    ( iFullChecks ? (double) iReducedSize / iFullChecks : 0. ) %
+    index.size() %
+    dMaxError %
+    dTolerance;
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_flow_helper.h
+//! \brief A header file to define reaction flow and entropy generation
+//!        diagnostic routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_FLOW_HELPER_H
+#define MY_FLOW_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/function.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "user/flow_utilities.h"
+
+#include "my_log_helper.h"
+#include "my_output_helper.h"
+
+#define S_FLOW_OUTPUT   "flow_output"
+#define S_SDOT_TOP_K    "sdot_top_k"
+#define S_SDOT_TOLERANCE        "sdot_tolerance"
+#define S_SDOT_CHECK_INTERVAL   "sdot_check_interval"
+#define S_SDOT_CHECK_THRESHOLD  "sdot_check_threshold"
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// reaction_index.
+//##############################################################################
+
+/**
+ * @brief A class to map the reactions of a network onto a flat array.
+ */
+
+class reaction_index
+{
+
+  public:
+    reaction_index( Libnucnet__Net * );
+
+    size_t size() const { return reactions.size(); }
+    size_t find( Libnucnet__Reaction * ) const;
+    Libnucnet__Reaction * reaction( size_t i ) const { return reactions[i]; }
+
+  private:
+    std::vector<Libnucnet__Reaction *> reactions;
+    std::map<const Libnucnet__Reaction *, size_t> pointer_map;
+    std::map<std::string, size_t> string_map;
+
+};
+
+//##############################################################################
+// step_flows.
+//##############################################################################
+
+/**
+ * @brief A class to compute the reaction flows once at the end of each
+ *        accepted step for all the per-reaction diagnostics.
+ *
+ * update() computes the flows of each reaction in the evolution network
+ * once, and the sdot contributions of the reactions in the sdot network,
+ * reusing those flows for reactions in both.  The values at the end of the
+ * previous step are kept, so a step's integral can use both ends.
+ */
+
+class step_flows
+{
+
+  public:
+    step_flows( const reaction_index& );
+
+    void update( nnt::Zone&, Libnucnet__NetView *, Libnucnet__NetView * );
+
+    bool hasPrevious() const { return bPrevious; }
+    const std::vector<double>& net() const { return net_flows; }
+    const std::vector<double>& previousNet() const { return previous_net; }
+    const std::vector<double>& sdot() const { return reaction_sdot; }
+    const std::vector<double>& previousSdot() const
+    {
+      return previous_sdot;
+    }
+    const std::vector<std::pair<size_t, double> >& contributions() const
+    {
+      return sdot_contributions;
+    }
+    double sdotTotal() const { return dSdotTotal; }
+
+  private:
+    const reaction_index& index;
+    bool bPrevious, bCurrent;
+    double dSdotTotal;
+    std::vector<double> net_flows, previous_net;
+    std::vector<double> reaction_sdot, previous_sdot;
+    std::vector<std::pair<double, double> > flows;
+    std::vector<bool> in_evolution;
+    std::vector<std::pair<size_t, double> > sdot_contributions;
+
+};
+
+//##############################################################################
+// flow_accumulator.
+//##############################################################################
+
+/**
+ * @brief A class to accumulate time-integrated net reaction flows over the
+ *        evolution network and entropy generation per reaction over the
+ *        sdot network.
+ *
+ * Each step is integrated with the trapezoid rule from the flows at its two
+ * ends, except the first, which has only its end.
+ */
+
+class flow_accumulator
+{
+
+  public:
+    flow_accumulator( const reaction_index& );
+
+    void accumulate( const step_flows&, double );
+
+    void write( const std::string& );
+
+    const std::vector<double>& getEntropyGeneration() const
+    {
+      return entropy_generation;
+    }
+
+  private:
+    const reaction_index& index;
+    std::vector<double> net_flows;
+    std::vector<double> entropy_generation;
+
+};
+
+//##############################################################################
+// sdot_breakdown.
+//##############################################################################
+
+/**
+ * @brief A class to track the K reactions contributing most to the entropy
+ *        generation rate, per step and over the run.
+ *
+ * Each step's contributions go through a size-K min-heap.  The class keeps
+ * the smallest and mean fraction of the step's sdot that its top K explain,
+ * and how often each reaction was in a step's top K.  The union of step top
+ * K sets is the smallest sdot view that gives every step that fraction.
+ */
+
+class sdot_breakdown
+{
+
+  public:
+    sdot_breakdown( const reaction_index&, size_t );
+
+    void
+    update( nnt::Zone&, Libnucnet__NetView *, const step_flows&, double );
+    void report( std::ostream& ) const;
+
+  private:
+    typedef std::pair<double, size_t> entry_t;
+    typedef
+      std::priority_queue<
+        entry_t, std::vector<entry_t>, std::greater<entry_t>
+      > heap_t;
+
+    const reaction_index& index;
+    size_t iK;
+    size_t iSteps;
+    double dMinFraction, dTimeMinFraction, dSumFraction, dTime;
+    double dRunFull, dRunUnattributed;
+    std::vector<double> run_sdot;
+    std::vector<size_t> top_counts;
+
+};
+
+//##############################################################################
+// adaptive_sdot.
+//##############################################################################
+
+/**
+ * @brief A class to compute the entropy generation rate over a reduced set
+ *        of reactions chosen from periodic full evaluations.
+ *
+ * A full check computes sdot over the whole view with the user function and
+ * splits it by reaction.  The reduced set is the smallest set of largest
+ * contributors whose sum is at least (1 - tolerance) of the total.  Until
+ * the next check, sdot is the sum over the reduced set, scaled by the ratio
+ * of the full to the reduced sum at the check.  A check is made after a
+ * given number of calls, when t9 or rho has changed by more than the
+ * relative threshold since the last check, or when the view generation
+ * (the limiter's rebuild count) changes.  At each check, the error of the
+ * old reduced estimate is measured and logged.
+ */
+
+class adaptive_sdot
+{
+
+  public:
+    adaptive_sdot(
+      const reaction_index&, double, size_t, double,
+      const boost::function<size_t( )>&
+    );
+
+    double operator()( nnt::Zone&, Libnucnet__NetView * );
+    void report( std::ostream& ) const;
+
+  private:
+    typedef std::pair<double, size_t> entry_t;
+
+    const reaction_index& index;
+    double dTolerance;
+    size_t iInterval;
+    double dThreshold;
+    size_t iCalls, iFullChecks, iReducedCalls, iReducedSize;
+    size_t iGenerationCheck;
+    double dT9Check, dRhoCheck, dScale, dFull, dMaxError;
+    bool bReduced;
+    boost::function<size_t( )> viewGeneration;
+    std::vector<Libnucnet__Reaction *> reduced_reactions;
+    std::vector<std::pair<size_t, double> > contributions;
+    std::vector<entry_t> entries;
+
+    double compute_reduced_sum( nnt::Zone& ) const;
+    double full_check( nnt::Zone&, Libnucnet__NetView * );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_flow_descriptions( po::options_description& );
+
+void
+set_flow_options( po::variables_map&, param_map_t& );
+
+double
+compute_reaction_sdot( const std::pair<double, double>& );
+
+double
+compute_sdot_contributions(
+  nnt::Zone&,
+  Libnucnet__NetView *,
+  const reaction_index&,
+  std::vector<std::pair<size_t, double> >&
+);
+
+} // namespace my_user
+
+#endif // MY_FLOW_HELPER_H
@@ -0,0 +1,438 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_format_helper.cpp
+//! \brief A file to define number formatting routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+#include "my_format_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// diy_fp.  A floating-point number f * 2^e with a 64-bit significand.
+//##############################################################################
+
+struct diy_fp
+{
+  boost::uint64_t f;
+  int e;
+  diy_fp( boost::uint64_t _f, int _e ) : f( _f ), e( _e ) {}
+};
+
+struct cached_power
+{
+  boost::uint64_t f;
+  int e;
+  int k;
+};
+
+//##############################################################################
+// Normalized 10^k for k = -300, -292, ..., 324.
+//##############################################################################
+
+static const int I_CACHED_POWERS_MIN_DEC_EXP = -300;
+static const int I_CACHED_POWERS_DEC_STEP = 8;
+static const int I_ALPHA = -60;
+
+static const cached_power cached_powers[] =
+{
+    { 0xAB70FE17C79AC6CAULL, -1060,  -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034,  -292 },
+    { 0xBE5691EF416BD60CULL, -1007,  -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980,  -276 },
+    { 0xD3515C2831559A83ULL,  -954,  -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927,  -260 },
+    { 0xEA9C227723EE8BCBULL,  -901,  -252 },
+    { 0xAECC49914078536DULL,  -874,  -244 },
+    { 0x823C12795DB6CE57ULL,  -847,  -236 },
+    { 0xC21094364DFB5637ULL,  -821,  -228 },
+    { 0x9096EA6F3848984FULL,  -794,  -220 },
+    { 0xD77485CB25823AC7ULL,  -768,  -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741,  -204 },
+    { 0xEF340A98172AACE5ULL,  -715,  -196 },
+    { 0xB23867FB2A35B28EULL,  -688,  -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661,  -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635,  -172 },
+    { 0x936B9FCEBB25C996ULL,  -608,  -164 },
+    { 0xDBAC6C247D62A584ULL,  -582,  -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555,  -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529,  -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502,  -132 },
+    { 0x87625F056C7C4A8BULL,  -475,  -124 },
+    { 0xC9BCFF6034C13053ULL,  -449,  -116 },
+    { 0x964E858C91BA2655ULL,  -422,  -108 },
+    { 0xDFF9772470297EBDULL,  -396,  -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,   -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,   -84 },
+    { 0xB94470938FA89BCFULL,  -316,   -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,   -68 },
+    { 0xCDB02555653131B6ULL,  -263,   -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,   -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,   -44 },
+    { 0xAA242499697392D3ULL,  -183,   -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,   -28 },
+    { 0xBCE5086492111AEBULL,  -130,   -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,   -12 },
+    { 0xD1B71758E219652CULL,   -77,    -4 },
+    { 0x9C40000000000000ULL,   -50,     4 },
+    { 0xE8D4A51000000000ULL,   -24,    12 },
+    { 0xAD78EBC5AC620000ULL,     3,    20 },
+    { 0x813F3978F8940984ULL,    30,    28 },
+    { 0xC097CE7BC90715B3ULL,    56,    36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,    44 },
+    { 0xD5D238A4ABE98068ULL,   109,    52 },
+    { 0x9F4F2726179A2245ULL,   136,    60 },
+    { 0xED63A231D4C4FB27ULL,   162,    68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,    76 },
+    { 0x83C7088E1AAB65DBULL,   216,    84 },
+    { 0xC45D1DF942711D9AULL,   242,    92 },
+    { 0x924D692CA61BE758ULL,   269,   100 },
+    { 0xDA01EE641A708DEAULL,   295,   108 },
+    { 0xA26DA3999AEF774AULL,   322,   116 },
+    { 0xF209787BB47D6B85ULL,   348,   124 },
+    { 0xB454E4A179DD1877ULL,   375,   132 },
+    { 0x865B86925B9BC5C2ULL,   402,   140 },
+    { 0xC83553C5C8965D3DULL,   428,   148 },
+    { 0x952AB45CFA97A0B3ULL,   455,   156 },
+    { 0xDE469FBD99A05FE3ULL,   481,   164 },
+    { 0xA59BC234DB398C25ULL,   508,   172 },
+    { 0xF6C69A72A3989F5CULL,   534,   180 },
+    { 0xB7DCBF5354E9BECEULL,   561,   188 },
+    { 0x88FCF317F22241E2ULL,   588,   196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,   204 },
+    { 0x98165AF37B2153DFULL,   641,   212 },
+    { 0xE2A0B5DC971F303AULL,   667,   220 },
+    { 0xA8D9D1535CE3B396ULL,   694,   228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,   236 },
+    { 0xBB764C4CA7A44410ULL,   747,   244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,   252 },
+    { 0xD01FEF10A657842CULL,   800,   260 },
+    { 0x9B10A4E5E9913129ULL,   827,   268 },
+    { 0xE7109BFBA19C0C9DULL,   853,   276 },
+    { 0xAC2820D9623BF429ULL,   880,   284 },
+    { 0x80444B5E7AA7CF85ULL,   907,   292 },
+    { 0xBF21E44003ACDD2DULL,   933,   300 },
+    { 0x8E679C2F5E44FF8FULL,   960,   308 },
+    { 0xD433179D9C8CB841ULL,   986,   316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,   324 }
+};
+
+//##############################################################################
+// diy_fp helpers.
+//##############################################################################
+
+static diy_fp
+diy_fp_sub( const diy_fp& x, const diy_fp& y )
+{
+  return diy_fp( x.f - y.f, x.e );
+}
+
+static diy_fp
+diy_fp_mul( const diy_fp& x, const diy_fp& y )
+{
+
+  const boost::uint64_t u_lo = x.f & 0xFFFFFFFFu;
+  const boost::uint64_t u_hi = x.f >> 32;
+  const boost::uint64_t v_lo = y.f & 0xFFFFFFFFu;
+  const boost::uint64_t v_hi = y.f >> 32;
+
+  const boost::uint64_t p0 = u_lo * v_lo;
+  const boost::uint64_t p1 = u_lo * v_hi;
+  const boost::uint64_t p2 = u_hi * v_lo;
+  const boost::uint64_t p3 = u_hi * v_hi;
+
+  boost::uint64_t q =
+    ( p0 >> 32 ) + ( p1 & 0xFFFFFFFFu ) + ( p2 & 0xFFFFFFFFu );
+
+  q += boost::uint64_t( 1 ) << 31;   // Round.
+
+  return
+    diy_fp( p3 + ( p2 >> 32 ) + ( p1 >> 32 ) + ( q >> 32 ), x.e + y.e + 64 );
+
+}
+
+static diy_fp
+diy_fp_normalize( diy_fp x )
+{
+  while( ( x.f >> 63 ) == 0 )
+  {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+static diy_fp
+diy_fp_normalize_to( const diy_fp& x, int i_target_e )
+{
+  return diy_fp( x.f << ( x.e - i_target_e ), i_target_e );
+}
+
+//##############################################################################
+// grisu2_round().
+//##############################################################################
+
+static void
+grisu2_round(
+  char * s_buf,
+  int i_len,
+  boost::uint64_t dist,
+  boost::uint64_t delta,
+  boost::uint64_t rest,
+  boost::uint64_t ten_k
+)
+{
+
+  while(
+    rest < dist &&
+    delta - rest >= ten_k &&
+    ( rest + ten_k < dist || dist - rest > rest + ten_k - dist )
+  )
+  {
+    s_buf[i_len - 1]--;
+    rest += ten_k;
+  }
+
+}
+
+//##############################################################################
+// grisu2_digit_gen().
+//##############################################################################
+
+static void
+grisu2_digit_gen(
+  char * s_buf,
+  int& i_len,
+  int& i_dec_exp,
+  const diy_fp& m_minus,
+  const diy_fp& w,
+  const diy_fp& m_plus
+)
+{
+
+  boost::uint64_t delta = diy_fp_sub( m_plus, m_minus ).f;
+  boost::uint64_t dist = diy_fp_sub( m_plus, w ).f;
+
+  const diy_fp one( boost::uint64_t( 1 ) << -m_plus.e, m_plus.e );
+
+  boost::uint32_t p1 = static_cast<boost::uint32_t>( m_plus.f >> -one.e );
+  boost::uint64_t p2 = m_plus.f & ( one.f - 1 );
+
+  boost::uint32_t pow10 = 1;
+  int n = 1;
+
+  while( n < 10 && p1 >= pow10 * 10u )
+  {
+    pow10 *= 10;
+    n++;
+  }
+
+  while( n > 0 )
+  {
+    s_buf[i_len++] = static_cast<char>( '0' + p1 / pow10 );
+    p1 %= pow10;
+    n--;
+
+    boost::uint64_t rest = ( boost::uint64_t( p1 ) << -one.e ) + p2;
+    if( rest <= delta )
+    {
+      i_dec_exp += n;
+      grisu2_round(
+        s_buf, i_len, dist, delta, rest, boost::uint64_t( pow10 ) << -one.e
+      );
+      return;
+    }
+
+    pow10 /= 10;
+  }
+
+  int m = 0;
+
+  for( ;; )
+  {
+    p2 *= 10;
+    s_buf[i_len++] = static_cast<char>( '0' + ( p2 >> -one.e ) );
+    p2 &= one.f - 1;
+    m++;
+
+    delta *= 10;
+    dist *= 10;
+    if( p2 <= delta ) break;
+  }
+
+  i_dec_exp -= m;
+
+  grisu2_round( s_buf, i_len, dist, delta, p2, one.f );
+
+}
+
+//##############################################################################
+// grisu2().
+//##############################################################################
+
+static void
+grisu2( char * s_buf, int& i_len, int& i_dec_exp, double d_x )
+{
+
+  boost::uint64_t bits;
+  std::memcpy( &bits, &d_x, sizeof( bits ) );
+
+  const boost::uint64_t hidden_bit = boost::uint64_t( 1 ) << 52;
+  const int i_bias = 1023 + 52;
+  const int i_e = static_cast<int>( bits >> 52 );
+  const boost::uint64_t f = bits & ( hidden_bit - 1 );
+
+  diy_fp v =
+    i_e == 0 ? diy_fp( f, 1 - i_bias ) : diy_fp( f + hidden_bit, i_e - i_bias );
+
+  const bool b_lower_closer = f == 0 && i_e > 1;
+
+  diy_fp m_plus = diy_fp_normalize( diy_fp( 2 * v.f + 1, v.e - 1 ) );
+  diy_fp m_minus =
+    diy_fp_normalize_to(
+      b_lower_closer ?
+        diy_fp( 4 * v.f - 1, v.e - 2 ) :
+        diy_fp( 2 * v.f - 1, v.e - 1 ),
+      m_plus.e
+    );
+  v = diy_fp_normalize( v );
+
+  // Choose c = 10^-k so that the scaled exponents lie in [alpha, gamma].
+
+  const int i_f = I_ALPHA - m_plus.e - 1;
+  const int i_k = ( i_f * 78913 ) / ( 1 << 18 ) + static_cast<int>( i_f > 0 );
+  const int i_index =
+    ( -I_CACHED_POWERS_MIN_DEC_EXP + i_k + ( I_CACHED_POWERS_DEC_STEP - 1 ) ) /
+    I_CACHED_POWERS_DEC_STEP;
+
+  const cached_power& cached = cached_powers[i_index];
+  const diy_fp c_minus_k( cached.f, cached.e );
+
+  const diy_fp w = diy_fp_mul( v, c_minus_k );
+  const diy_fp w_minus = diy_fp_mul( m_minus, c_minus_k );
+  const diy_fp w_plus = diy_fp_mul( m_plus, c_minus_k );
+
+  i_len = 0;
+  i_dec_exp = -cached.k;
+
+  grisu2_digit_gen(
+    s_buf,
+    i_len,
+    i_dec_exp,
+    diy_fp( w_minus.f + 1, w_minus.e ),
+    w,
+    diy_fp( w_plus.f - 1, w_plus.e )
+  );
+
+}
+
+//##############################################################################
+// format_double().
+//##############################################################################
+
+size_t
+format_double( char * s_buffer, double d_x )
+{
+
+  char s_digits[20];
+  int i_len, i_dec_exp, i_exp;
+  char * p = s_buffer;
+  boost::uint64_t bits;
+
+  if( !( d_x == d_x ) || std::fabs( d_x ) > 1.7976931348623157e308 )
+  {
+    return
+      static_cast<size_t>(
+        std::sprintf( s_buffer, "%e", d_x )
+      );
+  }
+
+  // Test the sign bit so that -0 keeps its sign.
+
+  std::memcpy( &bits, &d_x, sizeof( bits ) );
+
+  if( bits >> 63 )
+  {
+    *p++ = '-';
+    d_x = -d_x;
+  }
+
+  if( d_x == 0 )
+  {
+    std::strcpy( p, "0e+00" );
+    return static_cast<size_t>( p - s_buffer ) + 5;
+  }
+
+  grisu2( s_digits, i_len, i_dec_exp, d_x );
+
+  *p++ = s_digits[0];
+
+  if( i_len > 1 )
+  {
+    *p++ = '.';
+    std::memcpy( p, s_digits + 1, static_cast<size_t>( i_len - 1 ) );
+    p += i_len - 1;
+  }
+
+  i_exp = i_dec_exp + i_len - 1;
+
+  *p++ = 'e';
+  if( i_exp < 0 )
+  {
+    *p++ = '-';
+    i_exp = -i_exp;
+  }
+  else
+    *p++ = '+';
+
+  if( i_exp >= 100 )
+  {
+    *p++ = static_cast<char>( '0' + i_exp / 100 );
+    i_exp %= 100;
+  }
+  *p++ = static_cast<char>( '0' + i_exp / 10 );
+  *p++ = static_cast<char>( '0' + i_exp % 10 );
+  *p = '\0';
+
+  return static_cast<size_t>( p - s_buffer );
+
+}
+
+}  // namespace my_user
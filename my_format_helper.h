@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_format_helper.h
+//! \brief A header file to define number formatting routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_FORMAT_HELPER_H
+#define MY_FORMAT_HELPER_H
+
+#include <cstddef>
+
+#define I_FORMAT_BUFFER_SIZE  32   /* Large enough for any formatted double */
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+/**
+ * @brief Write a double in scientific notation with the fewest digits that
+ *        read back to the same double.
+ *
+ * The digits come from the Grisu2 algorithm (Loitsch 2010), which always
+ * round trips and is nearly always shortest.  The buffer must hold at least
+ * I_FORMAT_BUFFER_SIZE characters.  The output is null terminated.
+ *
+ * \param s_buffer The buffer to write to.
+ * \param d_x The double to format.
+ * \return The number of characters written (excluding the terminator).
+ */
+
+size_t
+format_double( char * s_buffer, double d_x );
+
+} // namespace my_user
+
+#endif // MY_FORMAT_HELPER_H
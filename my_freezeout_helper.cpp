@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_freezeout_helper.cpp
+//! \brief A file to define freeze-out detection helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_freezeout_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_freezeout_descriptions().
+//##############################################################################
+
+void
+get_freezeout_descriptions( po::options_description& freezeout )
+{
+
+  try
+  {
+
+    freezeout.add_options()
+
+      ( S_FREEZEOUT_WINDOW,
+        po::value<size_t>()->default_value( 0 ),
+        "Number of quiet steps that mark freeze-out (0 = no detection)"
+      )
+
+      ( S_FREEZEOUT_YDOT,
+        po::value<double>()->default_value( 1.e-6, "1.e-6" ),
+        "Largest relative abundance change rate (per s) of a quiet step"
+      )
+
+      ( S_FREEZEOUT_SDOT,
+        po::value<double>()->default_value( 1.e-6, "1.e-6" ),
+        "Largest relative entropy generation rate (per s) of a quiet step"
+      )
+
+      ( S_FREEZEOUT_ACTION,
+        po::value<std::string>()->default_value( S_FREEZEOUT_STOP ),
+        "Action at freeze-out (stop = write the state and stop, decay ="
+        " jump to the end time with decays only once the decay check"
+        " passes, unless flow output or the entropy breakdown is on)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_freezeout_options().
+//##############################################################################
+
+void
+set_freezeout_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_FREEZEOUT_WINDOW] = vmap[S_FREEZEOUT_WINDOW].as<size_t>();
+
+  param_map[S_FREEZEOUT_YDOT] = vmap[S_FREEZEOUT_YDOT].as<double>();
+
+  param_map[S_FREEZEOUT_SDOT] = vmap[S_FREEZEOUT_SDOT].as<double>();
+
+  if(
+    boost::any_cast<double>( param_map[S_FREEZEOUT_YDOT] ) < 0 ||
+    boost::any_cast<double>( param_map[S_FREEZEOUT_SDOT] ) < 0
+  )
+  {
+    std::cerr << "Freeze-out thresholds must not be negative." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_FREEZEOUT_ACTION] = vmap[S_FREEZEOUT_ACTION].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_FREEZEOUT_ACTION] ) !=
+      S_FREEZEOUT_STOP &&
+    boost::any_cast<std::string>( param_map[S_FREEZEOUT_ACTION] ) !=
+      S_FREEZEOUT_DECAY
+  )
+  {
+    std::cerr << "Unknown freeze-out action." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// freezeout_detector::freezeout_detector().
+//##############################################################################
+
+freezeout_detector::freezeout_detector(
+  size_t i_window,
+  double d_ydot,
+  double d_sdot
+) : iWindow( i_window ), iQuiet( 0 ), dYdot( d_ydot ), dSdot( d_sdot ),
+    dStart( 0 ), dTime( 0 ), bFrozen( false )
+{}
+
+//##############################################################################
+// freezeout_detector::update().  Call after each accepted step with the time
+// at the start of the step, the step, the entropy generation rate, and the
+// entropy.  Returns true on the step that completes the window.
+//##############################################################################
+
+bool
+freezeout_detector::update(
+  nnt::Zone& zone,
+  double d_t,
+  double d_dt,
+  double d_sdot,
+  double d_entropy
+)
+{
+
+  if( bFrozen || d_dt <= 0 ) return false;
+
+  bool b_quiet = fabs( d_sdot ) <= dSdot * fabs( d_entropy );
+
+  if( b_quiet )
+  {
+
+    gsl_vector * p_abundances =
+      Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+    gsl_vector * p_abundance_changes =
+      Libnucnet__Zone__getAbundanceChanges( zone.getNucnetZone() );
+
+    for( size_t i = 0; i < p_abundances->size && b_quiet; i++ )
+    {
+      double d_y = gsl_vector_get( p_abundances, i );
+      if(
+        d_y > D_FREEZEOUT_Y_MIN &&
+        fabs( gsl_vector_get( p_abundance_changes, i ) ) > dYdot * d_y * d_dt
+      )
+        b_quiet = false;
+    }
+
+    gsl_vector_free( p_abundances );
+    gsl_vector_free( p_abundance_changes );
+
+  }
+
+  if( !b_quiet )
+  {
+    iQuiet = 0;
+    return false;
+  }
+
+  if( iQuiet++ == 0 ) dStart = d_t;
+
+  if( iQuiet < iWindow ) return false;
+
+  dTime = dStart;
+  bFrozen = true;
+
+  return true;
+
+}
+
+//##############################################################################
+// freezeout_detector::report().
+//##############################################################################
+
+void
+freezeout_detector::report( std::ostream& os ) const
+{
+
+  if( bFrozen )
+    os << boost::format( "\nFreeze-out detected at t = %g s\n\n" ) % dTime;
+  else
+    os << "\nNo freeze-out detected\n\n";
+
+}
+
+}  // namespace my_user
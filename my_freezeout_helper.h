@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_freezeout_helper.h
+//! \brief A header file to define freeze-out detection helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_FREEZEOUT_HELPER_H
+#define MY_FREEZEOUT_HELPER_H
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_output_helper.h"
+
+#define S_FREEZEOUT_WINDOW  "freezeout_window"
+#define S_FREEZEOUT_YDOT    "freezeout_ydot"
+#define S_FREEZEOUT_SDOT    "freezeout_sdot"
+#define S_FREEZEOUT_ACTION  "freezeout_action"
+#define S_FREEZEOUT_STOP    "stop"
+#define S_FREEZEOUT_DECAY   "decay"
+
+#define D_FREEZEOUT_Y_MIN   1.e-10  /* Smallest y for the change rate test */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// freezeout_detector.
+//##############################################################################
+
+/**
+ * @brief A class to detect freeze-out from the step history.
+ *
+ * A step is quiet if no abundance above D_FREEZEOUT_Y_MIN changed at a
+ * relative rate above the abundance threshold and the entropy changed at a
+ * relative rate no larger than the entropy threshold.  Freeze-out is
+ * declared once the given number of consecutive steps are quiet, and the
+ * freeze-out time is the start of that run of steps.
+ */
+
+class freezeout_detector
+{
+
+  public:
+    freezeout_detector( size_t, double, double );
+
+    bool update( nnt::Zone&, double, double, double, double );
+    double time() const { return dTime; }
+    void report( std::ostream& ) const;
+
+  private:
+    size_t iWindow, iQuiet;
+    double dYdot, dSdot, dStart, dTime;
+    bool bFrozen;
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_freezeout_descriptions( po::options_description& );
+
+void
+set_freezeout_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_FREEZEOUT_HELPER_H
@@ -41,6 +41,8 @@ namespace my_user
 
 typedef std::vector< double > state_type;
 
+static size_t i_t9_solves = 0, i_t9_evaluations = 0;
+
 //##############################################################################
 // get_user_defined_descriptions().
 //##############################################################################
@@ -78,6 +80,11 @@ get_user_defined_descriptions( po::options_description& user )
         "Root expansion factor"
       )
 
+      ( S_ROOT_BRACKET, po::value<std::string>()->default_value( "fixed" ),
+        "T9 root bracketing (fixed = expand by the root factor, adaptive ="
+        " growing steps from the predicted change, then Brent)"
+      )
+
     ;
 
 // Add checks on input.
@@ -109,6 +116,16 @@ set_user_defined_options( po::variables_map& vmap, param_map_t& param_map )
   param_map[nnt::s_TAU] = vmap[nnt::s_TAU].as<double>();
   param_map[S_DELTA_TRAJ] = vmap[S_DELTA_TRAJ].as<double>();
   param_map[S_ROOT_FACTOR] = vmap[S_ROOT_FACTOR].as<double>();
+  param_map[S_ROOT_BRACKET] = vmap[S_ROOT_BRACKET].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_ROOT_BRACKET] ) != "fixed" &&
+    boost::any_cast<std::string>( param_map[S_ROOT_BRACKET] ) != "adaptive"
+  )
+  {
+    std::cerr << "root_bracket must be fixed or adaptive." << std::endl;
+    exit( EXIT_FAILURE );
+  }
   
   if(
     boost::any_cast<double>( param_map[S_RHO_1] ) >
@@ -226,19 +243,58 @@ double rho_function( param_map_t& param_map, const state_type& x )
 }
 
 //##############################################################################
-// t9_function().
+// t9_root().  Counts the evaluations of the T9 root function.
+//##############################################################################
+
+static double
+t9_root( double d_t9, nnt::Zone& zone, Libnucnet__NetView * p_view )
+{
+
+  i_t9_evaluations++;
+
+  return user::t9_from_entropy_root( d_t9, zone, p_view );
+
+}
+
+//##############################################################################
+// t9_function().  With the adaptive bracket, a width from the T9 predictor
+// sets the first step of the search, but never below the root factor's.  The
+// fixed bracket always expands by the root factor.
 //##############################################################################
 
 double t9_function(
   nnt::Zone& zone,
   param_map_t& param_map,
-  Libnucnet__NetView * p_view )
+  Libnucnet__NetView * p_view,
+  double d_width )
 {
 
+  i_t9_solves++;
+
+  if(
+    boost::any_cast<std::string>( param_map[S_ROOT_BRACKET] ) == "adaptive"
+  )
+  {
+    return
+      adaptive_1d_root(
+        boost::bind(
+          t9_root,
+          _1,
+          boost::ref( zone ),
+          p_view
+        ),
+        zone.getProperty<double>( nnt::s_T9 ),
+        GSL_MAX(
+          d_width,
+          boost::any_cast<double>( param_map[S_ROOT_FACTOR] ) - 1.
+        )
+      );
+  }
+
   double t9 =
     nnt::compute_1d_root(
       boost::bind(
-        user::t9_from_entropy_root,
+        t9_root,
         _1,
         boost::ref( zone ),
         p_view
@@ -251,6 +307,19 @@ double t9_function(
 
 }
 
+//##############################################################################
+// get_t9_solve_counts().
+//##############################################################################
+
+void
+get_t9_solve_counts( size_t& i_solves, size_t& i_evaluations )
+{
+
+  i_solves = i_t9_solves;
+  i_evaluations = i_t9_evaluations;
+
+}
+
 //##############################################################################
 // observer_function().
 //##############################################################################
@@ -40,7 +40,10 @@
 #include "user/evolve.h"
 #include "user/hydro_helper.h"
 
+#include "my_root_helper.h"
+
 #define S_ROOT_FACTOR   "root_factor"
+#define S_ROOT_BRACKET  "root_bracket"
 
 namespace po = boost::program_options;
 
@@ -72,7 +75,11 @@ acceleration( param_map_t&, nnt::Zone&, const state_type&, const double );
 
 double rho_function( param_map_t&, const state_type& );
 
-double t9_function( nnt::Zone& zone, param_map_t&, Libnucnet__NetView * );
+double
+t9_function( nnt::Zone& zone, param_map_t&, Libnucnet__NetView *, double );
+
+void
+get_t9_solve_counts( size_t&, size_t& );
 
 void
 observer_function( nnt::Zone&,
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_limiter_helper.cpp
+//! \brief A file to define network limiter helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_limiter_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_limiter_descriptions().
+//##############################################################################
+
+void
+get_limiter_descriptions( po::options_description& limiter )
+{
+
+  try
+  {
+
+    limiter.add_options()
+
+      ( S_LIMITER_MODE,
+        po::value<std::string>()->default_value( S_LIMITER_FULL ),
+        "Network limiter mode (full = run every step, mask = rebuild only"
+        " when the set of species above the cutoff changes)"
+      )
+
+      ( S_LIMITER_SKIP,
+        po::value<std::string>()->default_value( "yes" ),
+        "Skip the limiter when no abundance can have crossed the cutoff"
+        " (yes or no)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_limiter_options().
+//##############################################################################
+
+void
+set_limiter_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_LIMITER_MODE] = vmap[S_LIMITER_MODE].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_LIMITER_MODE] ) !=
+      S_LIMITER_FULL &&
+    boost::any_cast<std::string>( param_map[S_LIMITER_MODE] ) !=
+      S_LIMITER_MASK
+  )
+  {
+    std::cerr << "Unknown limiter mode." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_LIMITER_SKIP] = vmap[S_LIMITER_SKIP].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_LIMITER_SKIP] ) != "yes" &&
+    boost::any_cast<std::string>( param_map[S_LIMITER_SKIP] ) != "no"
+  )
+  {
+    std::cerr << "Limiter skip must be yes or no." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// network_limiter::network_limiter().
+//##############################################################################
+
+network_limiter::network_limiter(
+  Libnucnet__Net * p_net,
+  double d_cutoff,
+  const std::string& s_mode,
+  bool b_skip
+) : dCutoff( d_cutoff ), bMask( s_mode == S_LIMITER_MASK ), bSkip( b_skip ),
+    iCalls( 0 ), iRebuilds( 0 ), iSkipped( 0 ),
+    dMinDistance( 0 ), dChange( 0 )
+{
+
+  iSpecies =
+    Libnucnet__Nuc__getNumberOfSpecies( Libnucnet__Net__getNuc( p_net ) );
+  iWords = ( iSpecies + 63 ) / 64;
+
+  above.assign( iWords, 0 );
+
+}
+
+//##############################################################################
+// network_limiter::compute_mask().  The inner loop is branch free so that
+// the compiler can vectorize the compare.
+//##############################################################################
+
+void
+network_limiter::compute_mask( const gsl_vector * p_abundances )
+{
+
+  const double * p_y = p_abundances->data;
+
+  for( size_t w = 0; w < iWords; w++ )
+  {
+    size_t i_begin = w * 64;
+    size_t i_end = std::min( i_begin + 64, iSpecies );
+    word_t bits = 0;
+    for( size_t i = i_begin; i < i_end; i++ )
+      bits |= static_cast<word_t>( p_y[i] > dCutoff ) << ( i - i_begin );
+    above[w] = bits;
+  }
+
+}
+
+//##############################################################################
+// network_limiter::may_have_crossed().  For abundances y1 and y2 both
+// positive, |ln(y2/y1)| <= |y2 - y1| / min(y1,y2), so the sum of the largest
+// such ratio over the steps bounds the log change of every species.  A
+// species that moves to or from zero could have crossed anywhere.
+//##############################################################################
+
+bool
+network_limiter::may_have_crossed( const gsl_vector * p_abundances )
+{
+
+  const double * p_y = p_abundances->data;
+  double d_ratio = 0;
+  bool b_zero = false;
+
+  for( size_t i = 0; i < iSpecies; i++ )
+  {
+    double d_lo = std::min( y_last[i], p_y[i] );
+    double d_hi = std::max( y_last[i], p_y[i] );
+    if( d_lo > 0 )
+      d_ratio = std::max( d_ratio, ( d_hi - d_lo ) / d_lo );
+    else
+      b_zero |= d_hi > 0;
+    y_last[i] = p_y[i];
+  }
+
+  dChange += d_ratio;
+
+  return b_zero || dChange >= dMinDistance;
+
+}
+
+//##############################################################################
+// network_limiter::set_distance().
+//##############################################################################
+
+void
+network_limiter::set_distance( const gsl_vector * p_abundances )
+{
+
+  const double * p_y = p_abundances->data;
+
+  dMinDistance = GSL_POSINF;
+  dChange = 0;
+
+  for( size_t i = 0; i < iSpecies; i++ )
+  {
+    if( p_y[i] > 0 )
+      dMinDistance =
+        std::min( dMinDistance, fabs( log( p_y[i] / dCutoff ) ) );
+  }
+
+  y_last.assign( p_y, p_y + iSpecies );
+
+}
+
+//##############################################################################
+// network_limiter::operator()().
+//##############################################################################
+
+void
+network_limiter::operator()( nnt::Zone& zone )
+{
+
+  gsl_vector * p_abundances = NULL;
+
+  iCalls++;
+
+  if( bMask || bSkip )
+    p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  if( bSkip && iCalls > 1 && !may_have_crossed( p_abundances ) )
+  {
+    iSkipped++;
+    gsl_vector_free( p_abundances );
+    return;
+  }
+
+  if( bSkip ) set_distance( p_abundances );
+
+  if( bMask )
+  {
+
+    compute_mask( p_abundances );
+
+    if( iRebuilds > 0 && above == above_old )
+    {
+      gsl_vector_free( p_abundances );
+      return;
+    }
+
+    above_old = above;
+
+  }
+
+  if( p_abundances ) gsl_vector_free( p_abundances );
+
+  user::limit_evolution_network( zone, dCutoff );
+
+  iRebuilds++;
+
+}
+
+//##############################################################################
+// network_limiter::report().
+//##############################################################################
+
+void
+network_limiter::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format(
+      "\nNetwork limiter: %lu calls, %lu view rebuilds"
+    ) % iCalls % iRebuilds;
+
+  if( bSkip )
+    os <<
+      boost::format( ", %lu skipped (%.1f%%)" ) %
+      iSkipped %
+      ( iCalls ? 100. * iSkipped / iCalls : 0. );
+
+  os << "\n\n";
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_limiter_helper.h
+//! \brief A header file to define network limiter helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_LIMITER_HELPER_H
+#define MY_LIMITER_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "user/network_limiter.h"
+
+#define S_LIMITER_MODE  "limiter_mode"
+#define S_LIMITER_FULL  "full"
+#define S_LIMITER_MASK  "mask"
+#define S_LIMITER_SKIP  "limiter_skip"
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// network_limiter.
+//##############################################################################
+
+/**
+ * @brief A class to call user::limit_evolution_network only when its result
+ *        can change.
+ *
+ * In mask mode, the abundance vector is compared against the cutoff into a
+ * bit mask, one bit per species.  The limiter's view depends only on which
+ * species are above the cutoff, so the view is rebuilt only when the mask
+ * changes.  In full mode, the limiter runs on every call.  The rebuild count
+ * is the view's generation, so callers can tell when the view has changed.
+ *
+ * If skipping is on, each run records the smallest distance in log abundance
+ * of any species from the cutoff.  The relative abundance changes since then
+ * bound the change in log abundance, so while their sum stays below that
+ * distance no species can have crossed the cutoff and the call is skipped.
+ */
+
+class network_limiter
+{
+
+  public:
+    network_limiter(
+      Libnucnet__Net *, double, const std::string&, bool
+    );
+
+    void operator()( nnt::Zone& );
+    void report( std::ostream& ) const;
+
+    size_t generation() const { return iRebuilds; }
+
+  private:
+    typedef boost::uint64_t word_t;
+
+    double dCutoff;
+    bool bMask, bSkip;
+    size_t iSpecies, iWords;
+    size_t iCalls, iRebuilds, iSkipped;
+    double dMinDistance, dChange;
+    std::vector<word_t> above, above_old;
+    std::vector<double> y_last;
+
+    void compute_mask( const gsl_vector * );
+    bool may_have_crossed( const gsl_vector * );
+    void set_distance( const gsl_vector * );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_limiter_descriptions( po::options_description& );
+
+void
+set_limiter_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_LIMITER_HELPER_H
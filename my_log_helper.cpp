@@ -0,0 +1,619 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_log_helper.cpp
+//! \brief A file to define logging helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "my_log_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+static log_level_t log_level = LOG_WARN;
+
+//##############################################################################
+// get_log_descriptions().
+//##############################################################################
+
+void
+get_log_descriptions( po::options_description& log )
+{
+
+  try
+  {
+
+    log.add_options()
+
+      ( S_LOG_LEVEL,
+        po::value<std::string>()->default_value( "warn" ),
+        "Log level (error, warn, info, or debug); abundances print at debug"
+      )
+
+      ( S_ABUNDANCE_LOG,
+        po::value<std::string>(),
+        "Binary file for abundance dumps (default: none)"
+      )
+
+      ( S_OBSERVER_FILE,
+        po::value<std::string>(),
+        "Binary file for sampled observer records (required with"
+        " --observe ring)"
+      )
+
+      ( S_OBSERVER_SIZE,
+        po::value<size_t>()->default_value( 1024 ),
+        "Number of recent observer records kept for a crash dump"
+      )
+
+      ( S_OBSERVER_SAMPLE,
+        po::value<size_t>()->default_value( 100 ),
+        "Write every this many observer records to the observer file"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_log_options().
+//##############################################################################
+
+void
+set_log_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  const std::string& s = vmap[S_LOG_LEVEL].as<std::string>();
+
+  if( s == "error" )
+    set_log_level( LOG_ERROR );
+  else if( s == "warn" )
+    set_log_level( LOG_WARN );
+  else if( s == "info" )
+    set_log_level( LOG_INFO );
+  else if( s == "debug" )
+    set_log_level( LOG_DEBUG );
+  else
+  {
+    std::cerr << "Unknown log level." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_LOG_LEVEL] = s;
+
+  if( vmap.count( S_ABUNDANCE_LOG ) )
+    param_map[S_ABUNDANCE_LOG] = vmap[S_ABUNDANCE_LOG].as<std::string>();
+
+  if( vmap.count( S_OBSERVER_FILE ) )
+    param_map[S_OBSERVER_FILE] = vmap[S_OBSERVER_FILE].as<std::string>();
+
+  param_map[S_OBSERVER_SIZE] = vmap[S_OBSERVER_SIZE].as<size_t>();
+
+  param_map[S_OBSERVER_SAMPLE] = vmap[S_OBSERVER_SAMPLE].as<size_t>();
+
+  if(
+    boost::any_cast<size_t>( param_map[S_OBSERVER_SIZE] ) == 0 ||
+    boost::any_cast<size_t>( param_map[S_OBSERVER_SAMPLE] ) == 0
+  )
+  {
+    std::cerr << "Observer size and sample must be positive." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_log_level().
+//##############################################################################
+
+void
+set_log_level( log_level_t level )
+{
+  log_level = level;
+}
+
+//##############################################################################
+// log_enabled().
+//##############################################################################
+
+bool
+log_enabled( log_level_t level )
+{
+  return level <= log_level;
+}
+
+//##############################################################################
+// log_message().
+//##############################################################################
+
+void
+log_message( log_level_t level, const std::string& s_message )
+{
+
+  if( !log_enabled( level ) ) return;
+
+  if( level <= LOG_WARN )
+    std::cerr << s_message << "\n";
+  else
+    std::cout << s_message << "\n";
+
+}
+
+//##############################################################################
+// open_log_file().  Opens a binary log that starts with the given header.
+// When appending, an existing non-empty file must start with the same header,
+// which is then not written again; b_header says whether it is needed.
+//##############################################################################
+
+static std::FILE *
+open_log_file(
+  const std::string& s_file,
+  const std::vector<char>& header,
+  bool b_append,
+  bool& b_header
+)
+{
+
+  b_header = true;
+
+  if( b_append )
+  {
+
+    std::FILE * p_file = std::fopen( s_file.c_str(), "rb" );
+
+    if( p_file )
+    {
+
+      std::vector<char> existing( header.size() );
+
+      size_t i_read =
+        std::fread( &existing[0], 1, existing.size(), p_file );
+
+      std::fclose( p_file );
+
+      if( i_read > 0 )
+      {
+        if( existing != header )
+        {
+          std::cerr << "Existing file " << s_file <<
+            " does not match this run." << std::endl;
+          exit( EXIT_FAILURE );
+        }
+        b_header = false;
+      }
+
+    }
+
+  }
+
+  std::FILE * p_file = std::fopen( s_file.c_str(), b_append ? "ab" : "wb" );
+
+  if( !p_file )
+  {
+    std::cerr << "Could not open " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  return p_file;
+
+}
+
+//##############################################################################
+// abundance_log::abundance_log().  With b_append, as on a restart, dumps go
+// after those already in the file.
+//##############################################################################
+
+abundance_log::abundance_log(
+  const std::string& s_file,
+  Libnucnet__Net * p_net,
+  bool b_append
+)
+{
+
+  bool b_header;
+
+  buffer.reserve( I_LOG_BUFFER_SIZE );
+
+  buffer.insert(
+    buffer.end(),
+    S_ABUNDANCE_LOG_MAGIC,
+    S_ABUNDANCE_LOG_MAGIC + strlen( S_ABUNDANCE_LOG_MAGIC )
+  );
+
+  put(
+    static_cast<abundance_log_count_t>(
+      Libnucnet__Nuc__getNumberOfSpecies( Libnucnet__Net__getNuc( p_net ) )
+    )
+  );
+
+  nnt::species_list_t species_list =
+    nnt::make_species_list( Libnucnet__Net__getNuc( p_net ) );
+
+  BOOST_FOREACH( nnt::Species sp, species_list )
+  {
+    const char * s_name = Libnucnet__Species__getName( sp.getNucnetSpecies() );
+    put(
+      static_cast<abundance_log_count_t>(
+        Libnucnet__Species__getIndex( sp.getNucnetSpecies() )
+      )
+    );
+    put(
+      static_cast<abundance_log_count_t>(
+        Libnucnet__Species__getZ( sp.getNucnetSpecies() )
+      )
+    );
+    put(
+      static_cast<abundance_log_count_t>(
+        Libnucnet__Species__getA( sp.getNucnetSpecies() )
+      )
+    );
+    put( static_cast<abundance_log_count_t>( strlen( s_name ) ) );
+    buffer.insert( buffer.end(), s_name, s_name + strlen( s_name ) );
+  }
+
+  pFile = open_log_file( s_file, buffer, b_append, b_header );
+
+  if( !b_header ) buffer.clear();
+
+}
+
+//##############################################################################
+// abundance_log::~abundance_log().
+//##############################################################################
+
+abundance_log::~abundance_log()
+{
+  flush();
+  std::fclose( pFile );
+}
+
+//##############################################################################
+// abundance_log::flush().
+//##############################################################################
+
+void
+abundance_log::flush()
+{
+
+  if( buffer.empty() ) return;
+
+  if( std::fwrite( &buffer[0], 1, buffer.size(), pFile ) != buffer.size() )
+  {
+    std::cerr << "Error writing abundance log." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  buffer.clear();
+
+}
+
+//##############################################################################
+// abundance_log::write().
+//##############################################################################
+
+void
+abundance_log::write( nnt::Zone& zone, int i_label )
+{
+
+  gsl_vector * p_abundances;
+  abundance_log_count_t i_count = 0;
+  size_t i_count_pos;
+
+  put( static_cast<abundance_log_label_t>( i_label ) );
+  put( zone.getProperty<double>( nnt::s_TIME ) );
+  put( zone.getProperty<double>( nnt::s_T9 ) );
+  put( zone.getProperty<double>( nnt::s_RHO ) );
+  put( zone.getProperty<double>( nnt::s_ENTROPY_PER_NUCLEON ) );
+
+  i_count_pos = buffer.size();
+  put( i_count );
+
+  p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  for( size_t i = 0; i < p_abundances->size; i++ )
+  {
+    double d_y = gsl_vector_get( p_abundances, i );
+    if( d_y == 0 ) continue;
+    put( static_cast<abundance_log_count_t>( i ) );
+    put( d_y );
+    i_count++;
+  }
+
+  gsl_vector_free( p_abundances );
+
+  memcpy( &buffer[i_count_pos], &i_count, sizeof( i_count ) );
+
+  if( buffer.size() >= I_LOG_BUFFER_SIZE ) flush();
+
+}
+
+//##############################################################################
+// observer_ring::observer_ring().  With b_append, as on a restart, records go
+// after those already in the file.
+//##############################################################################
+
+observer_ring * observer_ring::pActive = NULL;
+
+observer_ring::observer_ring(
+  nnt::Zone& _zone,
+  const std::string& s_file,
+  size_t i_size,
+  size_t i_sample,
+  bool b_append
+) : zone( _zone ), ring( i_size ), iSequence( 0 ), iSample( i_sample ),
+    bClosed( false )
+{
+
+  bool b_header;
+
+  if( pActive )
+  {
+    std::cerr << "Only one observer ring may be active." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  if( s_file.size() + strlen( S_OBSERVER_CRASH ) >= I_OBSERVER_PATH )
+  {
+    std::cerr << "Observer file name is too long." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  std::vector<char> header(
+    S_OBSERVER_MAGIC, S_OBSERVER_MAGIC + strlen( S_OBSERVER_MAGIC )
+  );
+
+  pFile = open_log_file( s_file, header, b_append, b_header );
+
+  if( b_header )
+    std::fwrite(
+      S_OBSERVER_MAGIC, 1, strlen( S_OBSERVER_MAGIC ), pFile
+    );
+
+  strcpy( sCrashFile, s_file.c_str() );
+  strcat( sCrashFile, S_OBSERVER_CRASH );
+
+  samples.reserve( I_OBSERVER_FLUSH );
+
+  pActive = this;
+
+  static bool b_registered = false;
+
+  if( !b_registered )
+  {
+    std::atexit( at_exit );
+    b_registered = true;
+  }
+
+  std::signal( SIGSEGV, on_signal );
+  std::signal( SIGBUS, on_signal );
+  std::signal( SIGFPE, on_signal );
+  std::signal( SIGABRT, on_signal );
+
+}
+
+//##############################################################################
+// observer_ring::~observer_ring().
+//##############################################################################
+
+observer_ring::~observer_ring()
+{
+  close();
+}
+
+//##############################################################################
+// observer_ring::push().
+//##############################################################################
+
+void
+observer_ring::push( record& r )
+{
+
+  r.iSequence = iSequence;
+
+  ring[iSequence % ring.size()] = r;
+
+  if( iSequence++ % iSample == 0 )
+  {
+    samples.push_back( r );
+    if( samples.size() >= I_OBSERVER_FLUSH ) flush();
+  }
+
+}
+
+//##############################################################################
+// observer_ring::operator()().  Same arguments as observer_function().
+//##############################################################################
+
+void
+observer_ring::operator()(
+  const std::vector<double>& x,
+  const std::vector<double>& dxdt,
+  const double d_t
+)
+{
+
+  record r;
+
+  r.iKind = 0;
+  r.dTime = d_t;
+  r.dDt = d_t - zone.getProperty<double>( nnt::s_TIME );
+
+  for( size_t i = 0; i < 3; i++ )
+  {
+    r.x[i] = x[i];
+    r.dxdt[i] = dxdt[i];
+  }
+
+  push( r );
+
+}
+
+//##############################################################################
+// observer_ring::step().
+//##############################################################################
+
+void
+observer_ring::step( const std::vector<double>& x, double d_t, double d_dt )
+{
+
+  record r;
+
+  r.iKind = 1;
+  r.dTime = d_t;
+  r.dDt = d_dt;
+
+  for( size_t i = 0; i < 3; i++ )
+  {
+    r.x[i] = x[i];
+    r.dxdt[i] = 0;
+  }
+
+  push( r );
+
+}
+
+//##############################################################################
+// observer_ring::flush().
+//##############################################################################
+
+void
+observer_ring::flush()
+{
+
+  if( samples.empty() ) return;
+
+  if(
+    std::fwrite( &samples[0], sizeof( record ), samples.size(), pFile ) !=
+      samples.size()
+  )
+  {
+    std::cerr << "Error writing observer file." << std::endl;
+    samples.clear();
+    exit( EXIT_FAILURE );
+  }
+
+  samples.clear();
+
+}
+
+//##############################################################################
+// observer_ring::close().
+//##############################################################################
+
+void
+observer_ring::close()
+{
+
+  if( bClosed ) return;
+
+  flush();
+  std::fclose( pFile );
+
+  bClosed = true;
+  if( pActive == this ) pActive = NULL;
+
+}
+
+//##############################################################################
+// observer_ring::dump().  Only open(), write(), and close() are used, so
+// that this may run in a signal handler.
+//##############################################################################
+
+void
+observer_ring::dump() const
+{
+
+  int i_fd = open( sCrashFile, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+  if( i_fd < 0 ) return;
+
+  size_t i_size = ring.size();
+  size_t i_first = iSequence > i_size ? iSequence % i_size : 0;
+  size_t i_count = iSequence > i_size ? i_size : iSequence;
+
+  ssize_t i_written =
+    write( i_fd, S_OBSERVER_MAGIC, strlen( S_OBSERVER_MAGIC ) );
+
+  for( size_t i = 0; i < i_count && i_written >= 0; i++ )
+    i_written =
+      write( i_fd, &ring[( i_first + i ) % i_size], sizeof( record ) );
+
+  ::close( i_fd );
+
+}
+
+//##############################################################################
+// observer_ring::at_exit().  An exit without close() is abnormal.
+//##############################################################################
+
+void
+observer_ring::at_exit()
+{
+
+  if( !pActive ) return;
+
+  pActive->dump();
+  pActive->close();
+
+}
+
+//##############################################################################
+// observer_ring::on_signal().
+//##############################################################################
+
+void
+observer_ring::on_signal( int i_signal )
+{
+
+  if( pActive ) pActive->dump();
+
+  std::signal( i_signal, SIG_DFL );
+  std::raise( i_signal );
+
+}
+
+}  // namespace my_user
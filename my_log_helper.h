@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_log_helper.h
+//! \brief A header file to define logging helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_LOG_HELPER_H
+#define MY_LOG_HELPER_H
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_abundance_log_record.h"
+
+#define S_LOG_LEVEL       "log_level"
+#define S_ABUNDANCE_LOG   "abundance_log"
+#define S_OBSERVER_FILE   "observer_file"
+#define S_OBSERVER_SIZE   "observer_size"
+#define S_OBSERVER_SAMPLE "observer_sample"
+
+#define S_OBSERVER_MAGIC       "ENTOBSV1"
+#define S_OBSERVER_CRASH       ".crash"
+
+#define I_LOG_BUFFER_SIZE  1048576   /* Bytes buffered before a log flush */
+#define I_OBSERVER_FLUSH   4096      /* Sampled records before a flush */
+#define I_OBSERVER_PATH    4096      /* Longest crash file path */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// Log levels.  Messages at a level above the current one are not formatted.
+//##############################################################################
+
+enum log_level_t
+{
+  LOG_ERROR = 0,
+  LOG_WARN,
+  LOG_INFO,
+  LOG_DEBUG
+};
+
+//##############################################################################
+// abundance_log.
+//##############################################################################
+
+/**
+ * @brief A class to write abundance dumps to a buffered binary sidecar file.
+ *
+ * The layout is in my_abundance_log_record.h.  Use print_abundance_log to
+ * decode the file.  When appending to an
+ * existing log, its species table must match the network's.
+ */
+
+class abundance_log
+{
+
+  public:
+    abundance_log( const std::string&, Libnucnet__Net *, bool );
+    ~abundance_log();
+
+    void write( nnt::Zone&, int );
+    void flush();
+
+  private:
+    std::FILE * pFile;
+    std::vector<char> buffer;
+
+    template<typename T> void put( const T& t )
+    {
+      const char * p = reinterpret_cast<const char *>( &t );
+      buffer.insert( buffer.end(), p, p + sizeof( T ) );
+    }
+
+};
+
+//##############################################################################
+// observer_ring.
+//##############################################################################
+
+/**
+ * @brief A class to record right-hand side evaluations and accepted steps
+ *        without formatting them.
+ *
+ * Each record holds a sequence number, a kind (0 for a right-hand side
+ * evaluation, 1 for an accepted step), t, dt, x, and dxdt (zero for steps),
+ * all in native byte order after the magic string.  Every record goes into a
+ * fixed-size ring in memory, and every sampled record also goes to the
+ * file in batches.  If the process exits without close(), or dies on
+ * SIGSEGV, SIGBUS, SIGFPE, or SIGABRT, the ring is written in order to the
+ * file name with S_OBSERVER_CRASH appended, using only calls that are safe
+ * in a signal handler.  Only one ring can be active at a time.  Sequence
+ * numbers start from zero in each run, including one appended to a file.
+ */
+
+class observer_ring
+{
+
+  public:
+    observer_ring( nnt::Zone&, const std::string&, size_t, size_t, bool );
+    ~observer_ring();
+
+    void operator()(
+      const std::vector<double>&, const std::vector<double>&, const double
+    );
+    void step( const std::vector<double>&, double, double );
+    void close();
+
+  private:
+    struct record
+    {
+      boost::uint64_t iSequence;
+      boost::uint64_t iKind;
+      double dTime, dDt, x[3], dxdt[3];
+    };
+
+    nnt::Zone& zone;
+    std::FILE * pFile;
+    std::vector<record> ring, samples;
+    boost::uint64_t iSequence;
+    size_t iSample;
+    char sCrashFile[I_OBSERVER_PATH];
+    bool bClosed;
+
+    static observer_ring * pActive;
+
+    void push( record& );
+    void flush();
+    void dump() const;
+
+    static void at_exit();
+    static void on_signal( int );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_log_descriptions( po::options_description& );
+
+void
+set_log_options( po::variables_map&, param_map_t& );
+
+void
+set_log_level( log_level_t );
+
+bool
+log_enabled( log_level_t );
+
+void
+log_message( log_level_t, const std::string& );
+
+} // namespace my_user
+
+#endif // MY_LOG_HELPER_H
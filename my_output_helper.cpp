@@ -0,0 +1,1067 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_output_helper.cpp
+//! \brief A file to define output helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cctype>
+#include <cstring>
+
+#include "my_output_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_output_descriptions().
+//##############################################################################
+
+void
+get_output_descriptions( po::options_description& output )
+{
+
+  try
+  {
+
+    output.add_options()
+
+      ( S_OUTPUT_MODE,
+        po::value<std::string>()->default_value( S_OUTPUT_FULL ),
+        "Output mode (full, store, snapshot, or summary)"
+      )
+
+      ( S_MASS_FRACTION_FORMAT,
+        po::value<std::string>()->default_value( "%.15e" ),
+        "printf format for output mass fractions, or 'shortest' for the"
+        " shortest round-trip form (full and store output are formatted by"
+        " libnucnet with a printf format, so there 'shortest' writes %.17g,"
+        " which round trips but is not always shortest)"
+      )
+
+      ( S_COMPRESS_LEVEL,
+        po::value<int>()->default_value( 0 ),
+        "gzip compression level (1-9) for the output file (0 = none)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// valid_double_format().  True if the format has exactly one conversion,
+// and that conversion takes a double.  Literal text and %% are allowed.
+//##############################################################################
+
+static bool
+valid_double_format( const std::string& s_format )
+{
+
+  size_t i_conversions = 0;
+
+  for( size_t i = 0; i < s_format.size(); i++ )
+  {
+
+    if( s_format[i] != '%' ) continue;
+
+    if( ++i < s_format.size() && s_format[i] == '%' ) continue;
+
+    while( i < s_format.size() && strchr( "-+ #0", s_format[i] ) ) i++;
+    while( i < s_format.size() && isdigit( s_format[i] ) ) i++;
+    if( i < s_format.size() && s_format[i] == '.' )
+    {
+      i++;
+      while( i < s_format.size() && isdigit( s_format[i] ) ) i++;
+    }
+
+    if( i >= s_format.size() || !strchr( "eEfFgGaA", s_format[i] ) )
+      return false;
+
+    i_conversions++;
+
+  }
+
+  return i_conversions == 1;
+
+}
+
+//##############################################################################
+// set_output_options().
+//##############################################################################
+
+void
+set_output_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_OUTPUT_MODE] = vmap[S_OUTPUT_MODE].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) != S_OUTPUT_FULL &&
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) != S_OUTPUT_STORE &&
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) != S_OUTPUT_SNAPSHOT &&
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) != S_OUTPUT_SUMMARY
+  )
+  {
+    std::cerr << "Unknown output mode." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_MASS_FRACTION_FORMAT] =
+    vmap[S_MASS_FRACTION_FORMAT].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_MASS_FRACTION_FORMAT] ) !=
+      S_SHORTEST &&
+    !valid_double_format(
+      boost::any_cast<std::string>( param_map[S_MASS_FRACTION_FORMAT] )
+    )
+  )
+  {
+    std::cerr << "Mass fraction format must have exactly one floating-point " <<
+      "conversion (for example, %.15e)." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_COMPRESS_LEVEL] = vmap[S_COMPRESS_LEVEL].as<int>();
+
+  if(
+    boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] ) < 0 ||
+    boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] ) > 9
+  )
+  {
+    std::cerr << "Compression level must be between 0 and 9." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+#ifndef ENTROPY_ZLIB
+  if(
+    boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] ) > 0 &&
+    (
+      boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+        S_OUTPUT_SNAPSHOT ||
+      boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+        S_OUTPUT_SUMMARY
+    )
+  )
+  {
+    std::cerr << "Compressed snapshot or summary output needs a build with " <<
+      "ENTROPY_USE_ZLIB set." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+#endif
+
+}
+
+//##############################################################################
+// xml_escape().
+//##############################################################################
+
+std::string
+xml_escape( const char * s )
+{
+
+  std::string s_result;
+
+  for( ; *s; s++ )
+  {
+    switch( *s )
+    {
+      case '<': s_result += "&lt;"; break;
+      case '>': s_result += "&gt;"; break;
+      case '&': s_result += "&amp;"; break;
+      case '"': s_result += "&quot;"; break;
+      default: s_result += *s;
+    }
+  }
+
+  return s_result;
+
+}
+
+//##############################################################################
+// property_key().
+//##############################################################################
+
+std::string
+property_key( const char * s_name, const char * s_tag1, const char * s_tag2 )
+{
+
+  std::string s_key( s_name );
+
+  s_key += '\n';
+  if( s_tag1 ) s_key += s_tag1;
+  s_key += '\n';
+  if( s_tag2 ) s_key += s_tag2;
+
+  return s_key;
+
+}
+
+//##############################################################################
+// printf_mass_fraction_format().  The printf format to give libnucnet for
+// the mass fraction format option.  Libnucnet cannot call format_double(),
+// so the shortest form becomes %.17g, which round trips.
+//##############################################################################
+
+std::string
+printf_mass_fraction_format( const std::string& s_format )
+{
+  return s_format == S_SHORTEST ? S_ROUND_TRIP_FORMAT : s_format;
+}
+
+//##############################################################################
+// write_xml_output().  Writes the zones with libxml2's compression set to the
+// given level for this write only.
+//##############################################################################
+
+void
+write_xml_output( Libnucnet * p_nucnet, const char * s_file, int i_level )
+{
+
+  int i_mode = xmlGetCompressMode();
+
+  xmlSetCompressMode( i_level );
+
+  Libnucnet__writeToXmlFile( p_nucnet, s_file );
+
+  xmlSetCompressMode( i_mode );
+
+}
+
+//##############################################################################
+// output_stream::output_stream().
+//##############################################################################
+
+#ifdef ENTROPY_ZLIB
+
+output_stream::output_stream(
+  const std::string& s_file,
+  int i_level
+) : pFile( NULL ), pGzFile( NULL ), bDone( false ), bError( false )
+{
+
+  char s_mode[8];
+
+  if( i_level == 0 )
+  {
+    pFile = std::fopen( s_file.c_str(), "w" );
+  }
+  else
+  {
+    sprintf( s_mode, "wb%d", i_level );
+    pGzFile = gzopen( s_file.c_str(), s_mode );
+  }
+
+  if( !pFile && !pGzFile )
+  {
+    std::cerr << "Could not open output file " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  if( pGzFile )
+    thread = boost::thread( boost::bind( &output_stream::run, this ) );
+
+}
+
+#else
+
+output_stream::output_stream(
+  const std::string& s_file,
+  int i_level
+) : pFile( NULL )
+{
+
+  if( i_level != 0 )
+  {
+    std::cerr << "Compressed output needs a build with ENTROPY_USE_ZLIB set." <<
+      std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  pFile = std::fopen( s_file.c_str(), "w" );
+
+  if( !pFile )
+  {
+    std::cerr << "Could not open output file " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+#endif
+
+//##############################################################################
+// output_stream::~output_stream().
+//##############################################################################
+
+output_stream::~output_stream()
+{
+  close();
+}
+
+//##############################################################################
+// output_stream::write().  The chunk is swapped out, so the input is left
+// empty.
+//##############################################################################
+
+void
+output_stream::write( std::string& s_chunk )
+{
+
+  if( pFile )
+  {
+    if(
+      std::fwrite( s_chunk.data(), 1, s_chunk.size(), pFile ) !=
+        s_chunk.size()
+    )
+    {
+      std::cerr << "Error writing output." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+    s_chunk.clear();
+    return;
+  }
+
+#ifdef ENTROPY_ZLIB
+  boost::unique_lock<boost::mutex> lock( mutex );
+
+  while( queue.size() >= I_OUTPUT_QUEUE_SIZE && !bError )
+    condition.wait( lock );
+
+  if( bError )
+  {
+    lock.unlock();
+    close();
+    return;
+  }
+
+  queue.push_back( std::string() );
+  queue.back().swap( s_chunk );
+
+  condition.notify_all();
+#endif
+
+}
+
+#ifdef ENTROPY_ZLIB
+
+//##############################################################################
+// output_stream::run().  On a write error, the thread records the error and
+// stops, and the main thread reports it.
+//##############################################################################
+
+void
+output_stream::run()
+{
+
+  std::string s_chunk;
+
+  for( ;; )
+  {
+
+    {
+      boost::unique_lock<boost::mutex> lock( mutex );
+      while( queue.empty() && !bDone )
+        condition.wait( lock );
+      if( queue.empty() ) return;
+      s_chunk.swap( queue.front() );
+      queue.pop_front();
+      condition.notify_all();
+    }
+
+    if(
+      !s_chunk.empty() &&
+      gzwrite(
+        pGzFile,
+        s_chunk.data(),
+        static_cast<unsigned>( s_chunk.size() )
+      ) == 0
+    )
+    {
+      boost::lock_guard<boost::mutex> lock( mutex );
+      bError = true;
+      queue.clear();
+      condition.notify_all();
+      return;
+    }
+
+  }
+
+}
+
+#endif
+
+//##############################################################################
+// output_stream::close().
+//##############################################################################
+
+void
+output_stream::close()
+{
+
+  if( pFile )
+  {
+    int i_status = std::fclose( pFile );
+    pFile = NULL;
+    if( i_status != 0 )
+    {
+      std::cerr << "Error writing output." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+
+#ifdef ENTROPY_ZLIB
+  if( pGzFile )
+  {
+    {
+      boost::lock_guard<boost::mutex> lock( mutex );
+      bDone = true;
+      condition.notify_all();
+    }
+    thread.join();
+    if( gzclose( pGzFile ) != Z_OK ) bError = true;
+    pGzFile = NULL;
+    if( bError )
+    {
+      std::cerr << "Error writing compressed output." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+  }
+#endif
+
+}
+
+//##############################################################################
+// snapshot_writer::snapshot_writer().
+//##############################################################################
+
+snapshot_writer::snapshot_writer(
+  const std::string& s_file,
+  Libnucnet__Net * p_net,
+  std::set<std::string>& step_set,
+  const std::string& s_format,
+  int i_level
+) : stream( s_file, i_level ), step_properties( step_set ), bHeader( false ),
+    bClosed( false ), sFormat( s_format ), bShortest( s_format == S_SHORTEST )
+{
+
+  char s_line[256];
+
+  nnt::species_list_t species_list =
+    nnt::make_species_list( Libnucnet__Net__getNuc( p_net ) );
+
+  BOOST_FOREACH( nnt::Species sp, species_list )
+  {
+    species_entry entry;
+    entry.iA = Libnucnet__Species__getA( sp.getNucnetSpecies() );
+    entry.iIndex = Libnucnet__Species__getIndex( sp.getNucnetSpecies() );
+    sprintf(
+      s_line,
+      "      <nuclide name=\"%s\"><z>%u</z><a>%u</a><x>",
+      xml_escape( Libnucnet__Species__getName( sp.getNucnetSpecies() ) ).c_str(),
+      Libnucnet__Species__getZ( sp.getNucnetSpecies() ),
+      entry.iA
+    );
+    entry.sPrefix = s_line;
+    species.push_back( entry );
+  }
+
+  sBuffer = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  sBuffer += "<zone_data>\n";
+  stream.write( sBuffer );
+
+}
+
+//##############################################################################
+// snapshot_writer::~snapshot_writer().
+//##############################################################################
+
+snapshot_writer::~snapshot_writer()
+{
+  close();
+}
+
+//##############################################################################
+// snapshot_writer::close().
+//##############################################################################
+
+void
+snapshot_writer::close()
+{
+
+  if( bClosed ) return;
+
+  sBuffer = "</zone_data>\n";
+  stream.write( sBuffer );
+  stream.close();
+
+  bClosed = true;
+
+}
+
+//##############################################################################
+// snapshot_writer::write_property().
+//##############################################################################
+
+void
+snapshot_writer::write_property(
+  const char * s_name,
+  const char * s_tag1,
+  const char * s_tag2,
+  const char * s_value
+)
+{
+
+  sBuffer += "      <property name=\"";
+  sBuffer += xml_escape( s_name );
+  sBuffer += "\"";
+  if( s_tag1 )
+  {
+    sBuffer += " tag1=\"";
+    sBuffer += xml_escape( s_tag1 );
+    sBuffer += "\"";
+  }
+  if( s_tag2 )
+  {
+    sBuffer += " tag2=\"";
+    sBuffer += xml_escape( s_tag2 );
+    sBuffer += "\"";
+  }
+  sBuffer += ">";
+  sBuffer += xml_escape( s_value );
+  sBuffer += "</property>\n";
+
+}
+
+//##############################################################################
+// snapshot_writer::header_property_callback().
+//##############################################################################
+
+int
+snapshot_writer::header_property_callback(
+  const char * s_name,
+  const char * s_tag1,
+  const char * s_tag2,
+  const char * s_value,
+  void * p_data
+)
+{
+
+  snapshot_writer * p_writer = static_cast<snapshot_writer *>( p_data );
+
+  if( p_writer->step_properties.find( s_name ) !=
+      p_writer->step_properties.end()
+  )
+    return 1;
+
+  p_writer->static_properties[
+    property_key( s_name, s_tag1, s_tag2 )
+  ] = s_value;
+
+  p_writer->write_property( s_name, s_tag1, s_tag2, s_value );
+
+  return 1;
+
+}
+
+//##############################################################################
+// snapshot_writer::step_property_callback().
+//##############################################################################
+
+int
+snapshot_writer::step_property_callback(
+  const char * s_name,
+  const char * s_tag1,
+  const char * s_tag2,
+  const char * s_value,
+  void * p_data
+)
+{
+
+  snapshot_writer * p_writer = static_cast<snapshot_writer *>( p_data );
+
+  if(
+    p_writer->step_properties.find( s_name ) ==
+    p_writer->step_properties.end()
+  )
+  {
+    property_map_t::const_iterator it =
+      p_writer->static_properties.find(
+        property_key( s_name, s_tag1, s_tag2 )
+      );
+    if( it != p_writer->static_properties.end() && it->second == s_value )
+      return 1;
+  }
+
+  p_writer->write_property( s_name, s_tag1, s_tag2, s_value );
+
+  return 1;
+
+}
+
+//##############################################################################
+// snapshot_writer::write_header().
+//##############################################################################
+
+void
+snapshot_writer::write_header( nnt::Zone& zone )
+{
+
+  sBuffer = "  <static_properties>\n";
+
+  Libnucnet__Zone__iterateOptionalProperties(
+    zone.getNucnetZone(),
+    NULL,
+    NULL,
+    NULL,
+    (Libnucnet__Zone__optional_property_iterate_function)
+      header_property_callback,
+    this
+  );
+
+  sBuffer += "  </static_properties>\n";
+
+  stream.write( sBuffer );
+
+  bHeader = true;
+
+}
+
+//##############################################################################
+// snapshot_writer::write().
+//##############################################################################
+
+void
+snapshot_writer::write( nnt::Zone& zone )
+{
+
+  char s_number[I_FORMAT_BUFFER_SIZE];
+  gsl_vector * p_abundances;
+
+  if( !bHeader ) write_header( zone );
+
+  sBuffer = "  <zone label1=\"";
+  sBuffer += Libnucnet__Zone__getLabel( zone.getNucnetZone(), 1 );
+  sBuffer += "\" label2=\"0\" label3=\"0\">\n";
+  sBuffer += "    <optional_properties>\n";
+
+  Libnucnet__Zone__iterateOptionalProperties(
+    zone.getNucnetZone(),
+    NULL,
+    NULL,
+    NULL,
+    (Libnucnet__Zone__optional_property_iterate_function)
+      step_property_callback,
+    this
+  );
+
+  sBuffer += "    </optional_properties>\n";
+  sBuffer += "    <mass_fractions>\n";
+
+  p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  for( size_t i = 0; i < species.size(); i++ )
+  {
+    double d_y = gsl_vector_get( p_abundances, species[i].iIndex );
+    if( d_y == 0 ) continue;
+    sBuffer += species[i].sPrefix;
+    if( bShortest )
+    {
+      format_double( s_number, species[i].iA * d_y );
+      sBuffer += s_number;
+    }
+    else
+    {
+      int i_len =
+        snprintf(
+          s_number,
+          I_FORMAT_BUFFER_SIZE,
+          sFormat.c_str(),
+          species[i].iA * d_y
+        );
+      if( i_len < 0 )
+      {
+        std::cerr << "Could not format mass fraction." << std::endl;
+        exit( EXIT_FAILURE );
+      }
+      if( i_len < I_FORMAT_BUFFER_SIZE )
+      {
+        sBuffer += s_number;
+      }
+      else
+      {
+        std::vector<char> s_wide( i_len + 1 );
+        snprintf(
+          &s_wide[0], s_wide.size(), sFormat.c_str(), species[i].iA * d_y
+        );
+        sBuffer += &s_wide[0];
+      }
+    }
+    sBuffer += "</x></nuclide>\n";
+  }
+
+  gsl_vector_free( p_abundances );
+
+  sBuffer += "    </mass_fractions>\n";
+  sBuffer += "  </zone>\n";
+
+  stream.write( sBuffer );
+
+}
+
+//##############################################################################
+// snapshot_store::snapshot_store().
+//##############################################################################
+
+snapshot_store::snapshot_store(
+  Libnucnet__Net * p_net,
+  const std::string& s_format,
+  int i_level
+) : pNet( p_net ), sFormat( printf_mass_fraction_format( s_format ) ),
+    iLevel( i_level )
+{}
+
+//##############################################################################
+// snapshot_store::property_callback().
+//##############################################################################
+
+int
+snapshot_store::property_callback(
+  const char * s_name,
+  const char * s_tag1,
+  const char * s_tag2,
+  const char * s_value,
+  void * p_data
+)
+{
+
+  property_entry entry;
+
+  entry.sName = s_name;
+  entry.bTag1 = s_tag1 != NULL;
+  if( s_tag1 ) entry.sTag1 = s_tag1;
+  entry.bTag2 = s_tag2 != NULL;
+  if( s_tag2 ) entry.sTag2 = s_tag2;
+  entry.sValue = s_value;
+
+  static_cast<std::vector<property_entry> *>( p_data )->push_back( entry );
+
+  return 1;
+
+}
+
+//##############################################################################
+// snapshot_store::add().
+//##############################################################################
+
+void
+snapshot_store::add( nnt::Zone& zone )
+{
+
+  gsl_vector * p_abundances;
+
+  snapshots.push_back( snapshot() );
+
+  snapshot& snap = snapshots.back();
+
+  snap.sLabel1 = Libnucnet__Zone__getLabel( zone.getNucnetZone(), 1 );
+  snap.sLabel2 = Libnucnet__Zone__getLabel( zone.getNucnetZone(), 2 );
+  snap.sLabel3 = Libnucnet__Zone__getLabel( zone.getNucnetZone(), 3 );
+
+  Libnucnet__Zone__iterateOptionalProperties(
+    zone.getNucnetZone(),
+    NULL,
+    NULL,
+    NULL,
+    (Libnucnet__Zone__optional_property_iterate_function) property_callback,
+    &snap.properties
+  );
+
+  p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  snap.abundances.assign(
+    p_abundances->data,
+    p_abundances->data + p_abundances->size
+  );
+
+  gsl_vector_free( p_abundances );
+
+}
+
+//##############################################################################
+// snapshot_store::write().  The output structure keeps its own empty
+// network.  Each zone is made on the run's network, which a zone refers to
+// but does not own, so freeing the structure frees the zones and the empty
+// network and leaves the run's network alone.
+//##############################################################################
+
+void
+snapshot_store::write( const std::string& s_file )
+{
+
+  Libnucnet * p_output = Libnucnet__new();
+
+  Libnucnet__setZoneCompareFunction(
+    p_output,
+    (Libnucnet__Zone__compare_function) nnt::zone_compare_by_first_label
+  );
+
+  Libnucnet__updateZoneXmlMassFractionFormat( p_output, sFormat.c_str() );
+
+  for( size_t i = 0; i < snapshots.size(); i++ )
+  {
+
+    snapshot& snap = snapshots[i];
+
+    Libnucnet__Zone * p_zone =
+      Libnucnet__Zone__new(
+        pNet,
+        snap.sLabel1.c_str(),
+        snap.sLabel2.c_str(),
+        snap.sLabel3.c_str()
+      );
+
+    for( size_t j = 0; j < snap.properties.size(); j++ )
+    {
+      const property_entry& entry = snap.properties[j];
+      Libnucnet__Zone__updateProperty(
+        p_zone,
+        entry.sName.c_str(),
+        entry.bTag1 ? entry.sTag1.c_str() : NULL,
+        entry.bTag2 ? entry.sTag2.c_str() : NULL,
+        entry.sValue.c_str()
+      );
+    }
+
+    gsl_vector_view view =
+      gsl_vector_view_array( &snap.abundances[0], snap.abundances.size() );
+
+    Libnucnet__Zone__updateAbundances( p_zone, &view.vector );
+
+    Libnucnet__addZone( p_output, p_zone );
+
+    std::vector<property_entry>().swap( snap.properties );
+    std::vector<double>().swap( snap.abundances );
+
+  }
+
+  write_xml_output( p_output, s_file.c_str(), iLevel );
+
+  Libnucnet__free( p_output );
+
+}
+
+//##############################################################################
+// append_summary_property().
+//##############################################################################
+
+static void
+append_summary_property(
+  std::string& s_buffer,
+  const char * s_name,
+  double d_value
+)
+{
+
+  char s_number[I_FORMAT_BUFFER_SIZE];
+
+  format_double( s_number, d_value );
+
+  s_buffer += "  <property name=\"";
+  s_buffer += s_name;
+  s_buffer += "\">";
+  s_buffer += s_number;
+  s_buffer += "</property>\n";
+
+}
+
+//##############################################################################
+// trajectory_summary::trajectory_summary().
+//##############################################################################
+
+trajectory_summary::trajectory_summary() :
+  iSteps( 0 ), dT9Max( 0 ), dTimeT9Max( 0 ), dT9Min( GSL_POSINF ),
+  dRhoMax( 0 ), dRhoMin( GSL_POSINF ), dEntropyInitial( 0 ),
+  dEntropyFinal( 0 ), dEntropyGenerated( 0 ), dSdotMax( 0 ),
+  dTimeSdotMax( 0 ), dFreezeoutTime( 0 ), dTime( 0 )
+{}
+
+//##############################################################################
+// trajectory_summary::update().
+//##############################################################################
+
+void
+trajectory_summary::update(
+  double d_t,
+  double d_dt,
+  double d_t9,
+  double d_rho,
+  double d_entropy_old,
+  double d_entropy
+)
+{
+
+  double d_sdot = ( d_entropy - d_entropy_old ) / d_dt;
+
+  if( iSteps++ == 0 ) dEntropyInitial = d_entropy_old;
+
+  dTime = d_t;
+
+  if( d_t9 > dT9Max )
+  {
+    dT9Max = d_t9;
+    dTimeT9Max = d_t;
+  }
+  dT9Min = GSL_MIN( dT9Min, d_t9 );
+
+  dRhoMax = GSL_MAX( dRhoMax, d_rho );
+  dRhoMin = GSL_MIN( dRhoMin, d_rho );
+
+  dEntropyFinal = d_entropy;
+  dEntropyGenerated += d_entropy - d_entropy_old;
+
+  if( d_sdot > dSdotMax )
+  {
+    dSdotMax = d_sdot;
+    dTimeSdotMax = d_t;
+  }
+
+  if( d_sdot >= D_FREEZEOUT_FRACTION * dSdotMax ) dFreezeoutTime = d_t;
+
+}
+
+//##############################################################################
+// trajectory_summary::write().
+//##############################################################################
+
+void
+trajectory_summary::write(
+  const std::string& s_file,
+  nnt::Zone& zone,
+  int i_level
+)
+{
+
+  output_stream stream( s_file, i_level );
+  std::string s_buffer;
+  char s_line[256], s_number[I_FORMAT_BUFFER_SIZE];
+  gsl_vector * p_abundances;
+
+  s_buffer = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  s_buffer += "<trajectory_summary>\n";
+
+  sprintf(
+    s_line,
+    "  <property name=\"steps\">%lu</property>\n",
+    (unsigned long) iSteps
+  );
+  s_buffer += s_line;
+
+  append_summary_property( s_buffer, "time", dTime );
+  append_summary_property( s_buffer, "t9 max", dT9Max );
+  append_summary_property( s_buffer, "time of t9 max", dTimeT9Max );
+  append_summary_property( s_buffer, "t9 min", dT9Min );
+  append_summary_property( s_buffer, "rho max", dRhoMax );
+  append_summary_property( s_buffer, "rho min", dRhoMin );
+  append_summary_property(
+    s_buffer, "initial entropy per nucleon", dEntropyInitial
+  );
+  append_summary_property(
+    s_buffer, "final entropy per nucleon", dEntropyFinal
+  );
+  append_summary_property( s_buffer, "entropy generated", dEntropyGenerated );
+  append_summary_property( s_buffer, "sdot max", dSdotMax );
+  append_summary_property( s_buffer, "time of sdot max", dTimeSdotMax );
+  append_summary_property( s_buffer, "freeze-out time", dFreezeoutTime );
+
+  if( zone.hasProperty( S_DETECTED_FREEZEOUT_TIME ) )
+  {
+    append_summary_property(
+      s_buffer,
+      S_DETECTED_FREEZEOUT_TIME,
+      zone.getProperty<double>( S_DETECTED_FREEZEOUT_TIME )
+    );
+  }
+
+  s_buffer += "  <mass_fractions>\n";
+
+  p_abundances = Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+
+  nnt::species_list_t species_list =
+    nnt::make_species_list(
+      Libnucnet__Net__getNuc( Libnucnet__Zone__getNet( zone.getNucnetZone() ) )
+    );
+
+  BOOST_FOREACH( nnt::Species sp, species_list )
+  {
+    double d_x =
+      Libnucnet__Species__getA( sp.getNucnetSpecies() ) *
+      gsl_vector_get(
+        p_abundances,
+        Libnucnet__Species__getIndex( sp.getNucnetSpecies() )
+      );
+    if( d_x == 0 ) continue;
+    format_double( s_number, d_x );
+    sprintf(
+      s_line,
+      "    <nuclide name=\"%s\"><z>%u</z><a>%u</a><x>%s</x></nuclide>\n",
+      xml_escape( Libnucnet__Species__getName( sp.getNucnetSpecies() ) ).c_str(),
+      Libnucnet__Species__getZ( sp.getNucnetSpecies() ),
+      Libnucnet__Species__getA( sp.getNucnetSpecies() ),
+      s_number
+    );
+    s_buffer += s_line;
+  }
+
+  gsl_vector_free( p_abundances );
+
+  s_buffer += "  </mass_fractions>\n";
+  s_buffer += "</trajectory_summary>\n";
+
+  stream.write( s_buffer );
+  stream.close();
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_output_helper.h
+//! \brief A header file to define output helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_OUTPUT_HELPER_H
+#define MY_OUTPUT_HELPER_H
+
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include <boost/program_options.hpp>
+
+#ifdef ENTROPY_ZLIB
+#include <zlib.h>
+#include <boost/thread.hpp>
+#endif
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_format_helper.h"
+
+#define S_OUTPUT_MODE       "output_mode"
+#define S_OUTPUT_FULL       "full"
+#define S_OUTPUT_SNAPSHOT   "snapshot"
+#define S_OUTPUT_SUMMARY    "summary"
+#define S_OUTPUT_STORE      "store"
+#define S_MASS_FRACTION_FORMAT  "mass_fraction_format"
+#define S_SHORTEST          "shortest"
+#define S_ROUND_TRIP_FORMAT "%.17g"
+#define S_COMPRESS_LEVEL    "compress_level"
+#define S_DETECTED_FREEZEOUT_TIME  "detected freeze-out time"
+
+#define I_OUTPUT_QUEUE_SIZE  16   /* Chunks queued before a writer waits */
+
+#define D_FREEZEOUT_FRACTION 1.e-3 /* Fraction of peak sdot at freeze-out */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// output_stream.
+//##############################################################################
+
+/**
+ * @brief A class to write an output file, gzip compressed if the level is
+ *        non-zero.
+ *
+ * Compressed chunks are handed to a background thread so that compression
+ * does not hold up the time loop.  A write error in that thread is kept and
+ * reported by the next write() or by close().  Libxml2, and therefore
+ * libnucnet, reads gzip-compressed files transparently.  Compression needs
+ * a build with ENTROPY_ZLIB defined.
+ */
+
+class output_stream
+{
+
+  public:
+    output_stream( const std::string&, int );
+    ~output_stream();
+
+    void write( std::string& );
+    void close();
+
+  private:
+    std::FILE * pFile;
+#ifdef ENTROPY_ZLIB
+    gzFile pGzFile;
+    std::deque<std::string> queue;
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    boost::thread thread;
+    bool bDone, bError;
+
+    void run();
+#endif
+
+};
+
+//##############################################################################
+// snapshot_writer.
+//##############################################################################
+
+/**
+ * @brief A class to write zone snapshots with the static zone properties
+ *        stored once in a run header.
+ *
+ * Properties named in the step set are written with every snapshot.  All
+ * other properties go into the header with the first snapshot and are only
+ * written again in a snapshot if their value has changed.  Mass fractions
+ * are written with the given printf format or, if the format is "shortest",
+ * with format_double().
+ */
+
+class snapshot_writer
+{
+
+  public:
+    snapshot_writer(
+      const std::string&,
+      Libnucnet__Net *,
+      std::set<std::string>&,
+      const std::string&,
+      int
+    );
+    ~snapshot_writer();
+
+    void write( nnt::Zone& );
+    void close();
+
+  private:
+    struct species_entry
+    {
+      std::string sPrefix;
+      unsigned int iA;
+      size_t iIndex;
+    };
+
+    typedef std::map<std::string, std::string> property_map_t;
+
+    output_stream stream;
+    std::set<std::string> step_properties;
+    std::vector<species_entry> species;
+    property_map_t static_properties;
+    bool bHeader;
+    bool bClosed;
+    std::string sBuffer;
+    std::string sFormat;
+    bool bShortest;
+
+    void write_header( nnt::Zone& );
+    void write_property(
+      const char *, const char *, const char *, const char *
+    );
+
+    static int
+    header_property_callback(
+      const char *, const char *, const char *, const char *, void *
+    );
+
+    static int
+    step_property_callback(
+      const char *, const char *, const char *, const char *, void *
+    );
+
+};
+
+//##############################################################################
+// snapshot_store.
+//##############################################################################
+
+/**
+ * @brief A class to hold output snapshots without a copy of the network.
+ *
+ * Each snapshot keeps only the zone's labels, its properties in iteration
+ * order, and its abundance array.  At write time, the snapshots become
+ * zones made on the run's network and held in a separate Libnucnet
+ * structure, so the output is the same XML that a network copy holding the
+ * zones from nnt::write_xml() would write.  The run's own structure, its
+ * network, and its zones are left alone.
+ */
+
+class snapshot_store
+{
+
+  public:
+    snapshot_store( Libnucnet__Net *, const std::string&, int );
+
+    void add( nnt::Zone& );
+    void write( const std::string& );
+
+  private:
+    struct property_entry
+    {
+      std::string sName, sTag1, sTag2, sValue;
+      bool bTag1, bTag2;
+    };
+
+    struct snapshot
+    {
+      std::string sLabel1, sLabel2, sLabel3;
+      std::vector<property_entry> properties;
+      std::vector<double> abundances;
+    };
+
+    Libnucnet__Net * pNet;
+    std::string sFormat;
+    int iLevel;
+    std::vector<snapshot> snapshots;
+
+    static int
+    property_callback(
+      const char *, const char *, const char *, const char *, void *
+    );
+
+};
+
+//##############################################################################
+// trajectory_summary.
+//##############################################################################
+
+/**
+ * @brief A class to accumulate running reductions over a trajectory and
+ *        write them with the final abundances as one compact record.
+ *
+ * The freeze-out time is the last time the entropy generation rate was at
+ * least D_FREEZEOUT_FRACTION of its running peak.  A freeze-out time found
+ * by the freeze-out detector is written too if the zone has it.
+ */
+
+class trajectory_summary
+{
+
+  public:
+    trajectory_summary();
+
+    void update( double, double, double, double, double, double );
+    void write( const std::string&, nnt::Zone&, int );
+
+  private:
+    size_t iSteps;
+    double dT9Max, dTimeT9Max, dT9Min;
+    double dRhoMax, dRhoMin;
+    double dEntropyInitial, dEntropyFinal;
+    double dEntropyGenerated, dSdotMax, dTimeSdotMax;
+    double dFreezeoutTime, dTime;
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_output_descriptions( po::options_description& );
+
+void
+set_output_options( po::variables_map&, param_map_t& );
+
+std::string
+xml_escape( const char * );
+
+std::string
+property_key( const char *, const char *, const char * );
+
+std::string
+printf_mass_fraction_format( const std::string& );
+
+void
+write_xml_output( Libnucnet *, const char *, int );
+
+} // namespace my_user
+
+#endif // MY_OUTPUT_HELPER_H
@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_progress_helper.cpp
+//! \brief A file to define progress telemetry helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "my_progress_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_progress_descriptions().
+//##############################################################################
+
+void
+get_progress_descriptions( po::options_description& progress )
+{
+
+  try
+  {
+
+    progress.add_options()
+
+      ( S_PROGRESS_DIR,
+        po::value<std::string>(),
+        "Directory for the memory-mapped progress file read by entropy_top"
+        " (default: none)"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_progress_options().
+//##############################################################################
+
+void
+set_progress_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  if( vmap.count( S_PROGRESS_DIR ) )
+    param_map[S_PROGRESS_DIR] = vmap[S_PROGRESS_DIR].as<std::string>();
+
+}
+
+//##############################################################################
+// wall_time().  Seconds since the epoch.
+//##############################################################################
+
+double
+wall_time()
+{
+
+  struct timeval tv;
+
+  gettimeofday( &tv, NULL );
+
+  return tv.tv_sec + 1.e-6 * tv.tv_usec;
+
+}
+
+//##############################################################################
+// progress_publisher::progress_publisher().
+//##############################################################################
+
+progress_publisher * progress_publisher::pActive = NULL;
+
+progress_publisher::progress_publisher(
+  const std::string& s_dir,
+  double d_tend,
+  const std::string& s_output
+) : iRateSteps( 0 )
+{
+
+  char s_name[64];
+
+  sprintf( s_name, "/run_entropy.%ld%s", (long) getpid(), S_PROGRESS_SUFFIX );
+
+  std::string s_file = s_dir + s_name;
+  std::string s_temp = s_file + S_PROGRESS_TEMP_SUFFIX;
+
+  iFd = open( s_temp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+
+  if( iFd < 0 || ftruncate( iFd, sizeof( progress_record ) ) != 0 )
+  {
+    std::cerr << "Could not create progress file " << s_temp << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  void * p_map =
+    mmap(
+      NULL,
+      sizeof( progress_record ),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      iFd,
+      0
+    );
+
+  if( p_map == MAP_FAILED )
+  {
+    std::cerr << "Could not map progress file " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  pRecord = static_cast<progress_record *>( p_map );
+
+  begin();
+
+  memcpy( pRecord->sMagic, S_PROGRESS_MAGIC, sizeof( pRecord->sMagic ) );
+  pRecord->iPid = getpid();
+  pRecord->iState = PROGRESS_RUNNING;
+  pRecord->dTend = d_tend;
+  pRecord->dWallStart = pRecord->dWallUpdate = dRateWall = wall_time();
+  strncpy( pRecord->sOutput, s_output.c_str(), I_PROGRESS_OUTPUT - 1 );
+
+  end();
+
+  if( rename( s_temp.c_str(), s_file.c_str() ) != 0 )
+  {
+    std::cerr << "Could not create progress file " << s_file << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  pActive = this;
+
+  static bool b_registered = false;
+
+  if( !b_registered )
+  {
+    std::atexit( at_exit );
+    b_registered = true;
+  }
+
+}
+
+//##############################################################################
+// progress_publisher::~progress_publisher().
+//##############################################################################
+
+progress_publisher::~progress_publisher()
+{
+  if( pActive == this ) pActive = NULL;
+  munmap( pRecord, sizeof( progress_record ) );
+  close( iFd );
+}
+
+//##############################################################################
+// progress_publisher::begin() and end().  Bracket a change to the record.
+//##############################################################################
+
+void
+progress_publisher::begin()
+{
+  pRecord->iSequence++;
+  __sync_synchronize();
+}
+
+void
+progress_publisher::end()
+{
+  __sync_synchronize();
+  pRecord->iSequence++;
+}
+
+//##############################################################################
+// progress_publisher::update().  Call after each step with the evolution
+// view, the step count, t, dt, and the entropy.
+//##############################################################################
+
+void
+progress_publisher::update(
+  nnt::Zone& zone,
+  Libnucnet__NetView * p_view,
+  size_t i_steps,
+  double d_t,
+  double d_dt,
+  double d_entropy
+)
+{
+
+  double d_wall = wall_time();
+
+  begin();
+
+  pRecord->iSteps = i_steps;
+  pRecord->iSpecies =
+    Libnucnet__Nuc__getNumberOfSpecies(
+      Libnucnet__Net__getNuc( Libnucnet__NetView__getNet( p_view ) )
+    );
+  pRecord->iReactions =
+    Libnucnet__Reac__getNumberOfReactions(
+      Libnucnet__Net__getReac( Libnucnet__NetView__getNet( p_view ) )
+    );
+  pRecord->dTime = d_t;
+  pRecord->dDt = d_dt;
+  pRecord->dT9 = zone.getProperty<double>( nnt::s_T9 );
+  pRecord->dRho = zone.getProperty<double>( nnt::s_RHO );
+  pRecord->dEntropy = d_entropy;
+  pRecord->dWallUpdate = d_wall;
+
+  if( d_wall - dRateWall >= D_PROGRESS_RATE_INTERVAL )
+  {
+    pRecord->dStepsPerSecond = ( i_steps - iRateSteps ) / ( d_wall - dRateWall );
+    iRateSteps = i_steps;
+    dRateWall = d_wall;
+  }
+
+  end();
+
+}
+
+//##############################################################################
+// progress_publisher::finish().
+//##############################################################################
+
+void
+progress_publisher::finish( progress_state_t state )
+{
+
+  begin();
+
+  pRecord->iState = state;
+  pRecord->dWallUpdate = wall_time();
+
+  end();
+
+  if( pActive == this ) pActive = NULL;
+
+}
+
+//##############################################################################
+// progress_publisher::at_exit().  An exit before finish() is a failure.
+//##############################################################################
+
+void
+progress_publisher::at_exit()
+{
+  if( pActive ) pActive->finish( PROGRESS_FAILED );
+}
+
+}  // namespace my_user
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_progress_helper.h
+//! \brief A header file to define progress telemetry helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_PROGRESS_HELPER_H
+#define MY_PROGRESS_HELPER_H
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#include "my_progress_record.h"
+
+#define S_PROGRESS_DIR       "progress_dir"
+
+#define D_PROGRESS_RATE_INTERVAL  1.  /* Wall seconds between rate updates */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// progress_publisher.
+//##############################################################################
+
+/**
+ * @brief A class to publish a progress_record in a memory-mapped file.
+ *
+ * The file is run_entropy.<pid>.progress in the given directory.  It is
+ * created and filled under a temporary name and then renamed, so readers
+ * never see it empty or half written.  Updates are plain stores into the
+ * mapping under the record's sequence count, so they take no locks and make
+ * no system calls apart from reading the clock.  The file stays after the run with the final state so that
+ * entropy_top can show finished runs.  A run that calls exit() before
+ * finish() is marked failed.  A run killed by a signal leaves its state as
+ * running, which entropy_top reports as dead once the process is gone.
+ */
+
+class progress_publisher
+{
+
+  public:
+    progress_publisher( const std::string&, double, const std::string& );
+    ~progress_publisher();
+
+    void update(
+      nnt::Zone&, Libnucnet__NetView *, size_t, double, double, double
+    );
+    void finish( progress_state_t );
+
+  private:
+    int iFd;
+    progress_record * pRecord;
+    size_t iRateSteps;
+    double dRateWall;
+
+    static progress_publisher * pActive;
+
+    void begin();
+    void end();
+
+    static void at_exit();
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_progress_descriptions( po::options_description& );
+
+void
+set_progress_options( po::variables_map&, param_map_t& );
+
+double
+wall_time();
+
+} // namespace my_user
+
+#endif // MY_PROGRESS_HELPER_H
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_progress_record.h
+//! \brief A header file to define the progress record shared by run_entropy
+//!        and entropy_top.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_PROGRESS_RECORD_H
+#define MY_PROGRESS_RECORD_H
+
+#include <boost/cstdint.hpp>
+
+#define S_PROGRESS_MAGIC     "ENTPROG1"
+#define S_PROGRESS_SUFFIX    ".progress"
+#define S_PROGRESS_TEMP_SUFFIX ".tmp"  /* Added while a file is filled */
+
+#define I_PROGRESS_OUTPUT    64   /* Bytes kept of the output file name */
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// progress_state_t.
+//##############################################################################
+
+enum progress_state_t
+{
+  PROGRESS_RUNNING = 0,
+  PROGRESS_DONE,
+  PROGRESS_FAILED,
+  PROGRESS_CHECKPOINTED
+};
+
+//##############################################################################
+// progress_record.
+//##############################################################################
+
+/**
+ * @brief The fixed layout of a progress file.
+ *
+ * The writer makes iSequence odd before it changes any field and even
+ * again after, with full memory barriers in between.  A reader copies the
+ * record and keeps the copy only if iSequence was the same even number
+ * before and after the copy.  Times are in seconds, and the wall-clock
+ * times are seconds since the epoch.
+ */
+
+struct progress_record
+{
+  char sMagic[8];
+  volatile boost::uint64_t iSequence;
+  boost::uint64_t iPid, iState, iSteps, iSpecies, iReactions;
+  double dTime, dDt, dT9, dRho, dEntropy, dTend;
+  double dStepsPerSecond, dWallStart, dWallUpdate;
+  char sOutput[I_PROGRESS_OUTPUT];
+};
+
+} // namespace my_user
+
+#endif // MY_PROGRESS_RECORD_H
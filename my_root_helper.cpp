@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_root_helper.cpp
+//! \brief A file to define root finding helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_root_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// check_finite().
+//##############################################################################
+
+static double
+check_finite( double d_x, double d_f )
+{
+
+  if( !gsl_finite( d_f ) )
+  {
+    std::cerr <<
+      "Root function is not finite at x = " << d_x << "." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  return d_f;
+
+}
+
+//##############################################################################
+// brent().  Brent-Dekker iteration on a bracket [a, b] with known function
+// values of opposite sign.
+//##############################################################################
+
+static double
+brent(
+  const boost::function<double( double )>& f,
+  double a,
+  double b,
+  double fa,
+  double fb
+)
+{
+
+  double c = a, fc = fa, d = b - a, e = d;
+
+  for( size_t i = 0; i < I_ROOT_MAX_ITER; i++ )
+  {
+
+    if( ( fb > 0 && fc > 0 ) || ( fb < 0 && fc < 0 ) )
+    {
+      c = a;
+      fc = fa;
+      d = e = b - a;
+    }
+
+    if( fabs( fc ) < fabs( fb ) )
+    {
+      a = b; b = c; c = a;
+      fa = fb; fb = fc; fc = fa;
+    }
+
+    double tol = 0.5 * D_ROOT_TOLERANCE * fabs( b );
+    double m = 0.5 * ( c - b );
+
+    if( fabs( m ) <= tol || fb == 0 ) return b;
+
+    if( fabs( e ) >= tol && fabs( fa ) > fabs( fb ) )
+    {
+
+      double p, q, s = fb / fa;
+
+      if( a == c )
+      {
+        p = 2. * m * s;
+        q = 1. - s;
+      }
+      else
+      {
+        double r = fb / fc;
+        q = fa / fc;
+        p = s * ( 2. * m * q * ( q - r ) - ( b - a ) * ( r - 1. ) );
+        q = ( q - 1. ) * ( r - 1. ) * ( s - 1. );
+      }
+
+      if( p > 0 ) q = -q; else p = -p;
+
+      if( 2. * p < std::min( 3. * m * q - fabs( tol * q ), fabs( e * q ) ) )
+      {
+        e = d;
+        d = p / q;
+      }
+      else
+      {
+        d = m;
+        e = m;
+      }
+
+    }
+    else
+    {
+      d = m;
+      e = m;
+    }
+
+    a = b;
+    fa = fb;
+    b += fabs( d ) > tol ? d : ( m > 0 ? tol : -tol );
+    fb = check_finite( b, f( b ) );
+
+  }
+
+  std::cerr << "Brent iteration did not converge." << std::endl;
+  exit( EXIT_FAILURE );
+
+}
+
+//##############################################################################
+// adaptive_1d_root().
+//##############################################################################
+
+double
+adaptive_1d_root(
+  const boost::function<double( double )>& f,
+  double d_guess,
+  double d_step
+)
+{
+
+  double x0 = d_guess, f0 = check_finite( x0, f( x0 ) );
+
+  if( f0 == 0 ) return x0;
+
+  double d_h =
+    std::min(
+      log1p( std::max( d_step, D_ROOT_MIN_STEP ) ),
+      D_ROOT_MAX_LOG_STEP
+    );
+
+  double x1 = x0 * exp( d_h ), f1 = check_finite( x1, f( x1 ) );
+
+  //============================================================================
+  // Keep going in the direction in which |f| falls.
+  //============================================================================
+
+  if( ( f0 > 0 ) == ( f1 > 0 ) && f1 != 0 && fabs( f1 ) > fabs( f0 ) )
+  {
+    d_h = -d_h;
+    x1 = x0 * exp( d_h );
+    f1 = check_finite( x1, f( x1 ) );
+  }
+
+  double d_growth = D_ROOT_GROWTH;
+
+  for( size_t i = 0; ( f0 > 0 ) == ( f1 > 0 ) && f1 != 0; i++ )
+  {
+
+    if( i == I_ROOT_MAX_EXPAND )
+    {
+      std::cerr << "Could not bracket root." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+
+    x0 = x1;
+    f0 = f1;
+    d_h =
+      GSL_SIGN( d_h ) * std::min( fabs( d_h ) * d_growth, D_ROOT_MAX_LOG_STEP );
+    d_growth = std::min( d_growth * D_ROOT_GROWTH_RATE, D_ROOT_MAX_GROWTH );
+    x1 = x0 * exp( d_h );
+    f1 = check_finite( x1, f( x1 ) );
+
+  }
+
+  if( f1 == 0 ) return x1;
+
+  return brent( f, x0, x1, f0, f1 );
+
+}
+
+}  // namespace my_user
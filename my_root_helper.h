@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_root_helper.h
+//! \brief A header file to define root finding helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_ROOT_HELPER_H
+#define MY_ROOT_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/function.hpp>
+
+#include <gsl/gsl_math.h>
+
+#define D_ROOT_TOLERANCE   1.e-10  /* Relative tolerance of the root */
+#define D_ROOT_MIN_STEP    1.e-8   /* Smallest relative initial step */
+#define D_ROOT_GROWTH      1.6     /* Initial bracket step growth factor */
+#define D_ROOT_GROWTH_RATE 1.5     /* Growth of the growth factor */
+#define D_ROOT_MAX_GROWTH  8.      /* Largest growth factor */
+#define D_ROOT_MAX_LOG_STEP M_LN2  /* Largest step in the log */
+#define I_ROOT_MAX_EXPAND  200     /* Most bracket expansions */
+#define I_ROOT_MAX_ITER    100     /* Most Brent iterations */
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+/**
+ * @brief Find the root of a function of a positive variable.
+ *
+ * The search starts at the guess and steps away from it in the log of the
+ * variable, first by the relative step and then by steps that grow by a
+ * factor that itself grows, in the direction in which the function decreases
+ * in magnitude.  The growth factor stops at D_ROOT_MAX_GROWTH and each step
+ * changes the variable by at most a factor of two, so the bracket stays
+ * finite.  Once the root is bracketed, Brent's method finishes the solve
+ * without evaluating the bracket ends again.  A non-finite function value
+ * is an error.
+ */
+
+double
+adaptive_1d_root( const boost::function<double( double )>&, double, double );
+
+} // namespace my_user
+
+#endif // MY_ROOT_HELPER_H
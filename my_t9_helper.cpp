@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_t9_helper.cpp
+//! \brief A file to define T9 prediction helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_t9_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_t9_descriptions().
+//##############################################################################
+
+void
+get_t9_descriptions( po::options_description& t9 )
+{
+
+  try
+  {
+
+    t9.add_options()
+
+      ( S_T9_GUESS_ORDER,
+        po::value<size_t>()->default_value( 1 ),
+        "Order (1 to 3) of the polynomial extrapolation for the T9 guess"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_t9_options().
+//##############################################################################
+
+void
+set_t9_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_T9_GUESS_ORDER] = vmap[S_T9_GUESS_ORDER].as<size_t>();
+
+  if(
+    boost::any_cast<size_t>( param_map[S_T9_GUESS_ORDER] ) < 1 ||
+    boost::any_cast<size_t>( param_map[S_T9_GUESS_ORDER] ) > 3
+  )
+  {
+    std::cerr << "T9 guess order must be 1, 2, or 3." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// t9_predictor::t9_predictor().
+//##############################################################################
+
+t9_predictor::t9_predictor( size_t i_order ) :
+  iOrder( i_order ), dGuess( 0 ), dError( 0 ), bGuess( false )
+{}
+
+//##############################################################################
+// t9_predictor::predict().  Until there are two pairs, the guess is the last
+// T9.
+//##############################################################################
+
+double
+t9_predictor::predict( double d_t )
+{
+
+  if( history.size() < 2 )
+  {
+    bGuess = false;
+    return history.empty() ? 0 : history.back().second;
+  }
+
+  dGuess = extrapolate( d_t );
+
+  bGuess = dGuess > 0;
+
+  return bGuess ? dGuess : history.back().second;
+
+}
+
+//##############################################################################
+// t9_predictor::extrapolate().  The Lagrange polynomial through the history,
+// without recording a guess.
+//##############################################################################
+
+double
+t9_predictor::extrapolate( double d_t ) const
+{
+
+  double d_t9 = 0;
+
+  if( history.size() < 2 ) return history.empty() ? 0 : history.back().second;
+
+  for( size_t i = 0; i < history.size(); i++ )
+  {
+    double d_l = 1;
+    for( size_t j = 0; j < history.size(); j++ )
+    {
+      if( j != i )
+        d_l *=
+          ( d_t - history[j].first ) /
+          ( history[i].first - history[j].first );
+    }
+    d_t9 += d_l * history[i].second;
+  }
+
+  return d_t9;
+
+}
+
+//##############################################################################
+// t9_predictor::update().
+//##############################################################################
+
+void
+t9_predictor::update( double d_t, double d_t9 )
+{
+
+  if( bGuess )
+    dError =
+      std::max( fabs( dGuess - d_t9 ) / d_t9, D_T9_ERROR_DECAY * dError );
+
+  bGuess = false;
+
+  history.push_back( std::make_pair( d_t, d_t9 ) );
+
+  if( history.size() > iOrder + 1 ) history.pop_front();
+
+}
+
+//##############################################################################
+// t9_predictor::width().  Zero until a guess has been checked, which leaves
+// the solve with the root factor.
+//##############################################################################
+
+double
+t9_predictor::width() const
+{
+
+  if( dError == 0 ) return 0;
+
+  return std::max( D_T9_BRACKET_SAFETY * dError, D_T9_BRACKET_MIN );
+
+}
+
+//##############################################################################
+// t9_predictor::report().
+//##############################################################################
+
+void
+t9_predictor::report( std::ostream& os, size_t i_steps ) const
+{
+
+  size_t i_solves, i_evaluations;
+
+  get_t9_solve_counts( i_solves, i_evaluations );
+
+  os <<
+    boost::format(
+      "\nT9 solve: %lu solves, %.2f root evaluations per solve, %.2f per step"
+      "\n\n"
+    ) %
+    i_solves %
+    ( i_solves ? (double) i_evaluations / i_solves : 0. ) %
+    ( i_steps ? (double) i_evaluations / i_steps : 0. );
+
+}
+
+}  // namespace my_user
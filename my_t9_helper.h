@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_t9_helper.h
+//! \brief A header file to define T9 prediction helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_T9_HELPER_H
+#define MY_T9_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include "my_hydro_helper.h"
+
+#define S_T9_GUESS_ORDER  "t9_guess_order"
+
+#define D_T9_BRACKET_SAFETY  2.    /* Bracket width over predictor error */
+#define D_T9_BRACKET_MIN     1.e-4 /* Smallest relative bracket width */
+#define D_T9_ERROR_DECAY     0.5   /* Decay of the remembered predictor error */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// t9_predictor.
+//##############################################################################
+
+/**
+ * @brief A class to extrapolate T9 from the last few solved (t, T9) pairs.
+ *
+ * The guess is the Lagrange polynomial through the last order + 1 pairs, so
+ * order one is the linear guess.  The relative error of each guess is kept
+ * as a decaying maximum, and the bracket width for the next root solve is
+ * D_T9_BRACKET_SAFETY times that error.  Only the adaptive root bracket uses
+ * the width, and never below the root factor's.
+ */
+
+class t9_predictor
+{
+
+  public:
+    t9_predictor( size_t );
+
+    double predict( double );
+    double extrapolate( double ) const;
+    void update( double, double );
+    double width() const;
+    void report( std::ostream&, size_t ) const;
+
+  private:
+    size_t iOrder;
+    std::deque<std::pair<double, double> > history;
+    double dGuess, dError;
+    bool bGuess;
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_t9_descriptions( po::options_description& );
+
+void
+set_t9_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_T9_HELPER_H
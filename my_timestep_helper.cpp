@@ -0,0 +1,336 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_timestep_helper.cpp
+//! \brief A file to define time step helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include "my_timestep_helper.h"
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+//##############################################################################
+// get_timestep_descriptions().
+//##############################################################################
+
+void
+get_timestep_descriptions( po::options_description& timestep )
+{
+
+  try
+  {
+
+    timestep.add_options()
+
+      ( S_DT_CONTROLLER,
+        po::value<std::string>()->default_value( S_DT_STANDARD ),
+        "Time step controller (standard, predictive, or pi)"
+      )
+
+      ( S_DT_GROWTH,
+        po::value<double>()->default_value( 2., "2." ),
+        "Largest factor by which the predictive or pi controller grows dt"
+        " per step"
+      )
+
+      ( S_PI_KI,
+        po::value<double>()->default_value( 0.3, "0.3" ),
+        "Integral gain of the pi time step controller"
+      )
+
+      ( S_PI_KP,
+        po::value<double>()->default_value( 0.4, "0.4" ),
+        "Proportional gain of the pi time step controller"
+      )
+
+    ;
+
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    exit( EXIT_FAILURE );
+  }
+  catch(...)
+  {
+    std::cerr << "Exception of unknown type!\n";
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// set_timestep_options().
+//##############################################################################
+
+void
+set_timestep_options( po::variables_map& vmap, param_map_t& param_map )
+{
+
+  param_map[S_DT_CONTROLLER] = vmap[S_DT_CONTROLLER].as<std::string>();
+
+  if(
+    boost::any_cast<std::string>( param_map[S_DT_CONTROLLER] ) !=
+      S_DT_STANDARD &&
+    boost::any_cast<std::string>( param_map[S_DT_CONTROLLER] ) !=
+      S_DT_PREDICTIVE &&
+    boost::any_cast<std::string>( param_map[S_DT_CONTROLLER] ) != S_DT_PI
+  )
+  {
+    std::cerr << "Unknown time step controller." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_DT_GROWTH] = vmap[S_DT_GROWTH].as<double>();
+
+  if( boost::any_cast<double>( param_map[S_DT_GROWTH] ) <= 1. )
+  {
+    std::cerr << "Time step growth factor must be greater than one." <<
+      std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  param_map[S_PI_KI] = vmap[S_PI_KI].as<double>();
+  param_map[S_PI_KP] = vmap[S_PI_KP].as<double>();
+
+  if(
+    boost::any_cast<double>( param_map[S_PI_KI] ) < 0 ||
+    boost::any_cast<double>( param_map[S_PI_KP] ) < 0
+  )
+  {
+    std::cerr << "PI controller gains must not be negative." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+}
+
+//##############################################################################
+// step_controller::step_controller().
+//##############################################################################
+
+step_controller::step_controller(
+  const std::string& s_mode,
+  double d_reg_t,
+  double d_reg_y,
+  double d_reg_x,
+  double d_y_min,
+  double d_growth,
+  double d_ki,
+  double d_kp
+) : sMode( s_mode ), dRegT( d_reg_t ), dRegY( d_reg_y ), dRegX( d_reg_x ),
+    dYMin( d_y_min ), dGrowth( d_growth ), dKI( d_ki ), dKP( d_kp ),
+    iSteps( 0 ), iHistory( 0 ), iGrowthLimited( 0 ), dErrorLast( 0 ),
+    dLogRatioSum( 0 )
+{}
+
+//##############################################################################
+// step_controller::horizon().  The largest h with a * h + b * h^2 <= eps.
+//##############################################################################
+
+double
+step_controller::horizon( double d_a, double d_b, double d_eps )
+{
+
+  if( d_a == 0 && d_b == 0 ) return GSL_POSINF;
+
+  return 2. * d_eps / ( d_a + sqrt( d_a * d_a + 4. * d_b * d_eps ) );
+
+}
+
+//##############################################################################
+// step_controller::predict().  The zone's rates are those of the step just
+// taken, so the flow vector is the derivative at its end.
+//##############################################################################
+
+void
+step_controller::predict(
+  nnt::Zone& zone,
+  double& d_dt,
+  const boost::function<double( double )>& hydro_change
+)
+{
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+  gsl_vector * p_ydot =
+    Libnucnet__Zone__computeFlowVector( zone.getNucnetZone() );
+  const double * p_y = p_abundances->data;
+  double d_h = dGrowth * d_dt;
+  bool b_growth = true;
+
+  if( iHistory++ == 0 ) rates.assign( p_abundances->size, 0. );
+
+  for( size_t i = 0; i < p_abundances->size; i++ )
+  {
+
+    double d_rate = 0;
+
+    if( p_y[i] > dYMin )
+    {
+      d_rate = gsl_vector_get( p_ydot, i ) / p_y[i];
+      double d_acc = rates[i] != 0 ? ( d_rate - rates[i] ) / d_dt : 0;
+      double d_hi = horizon( fabs( d_rate ), 0.5 * fabs( d_acc ), dRegY );
+      if( d_hi < d_h )
+      {
+        d_h = d_hi;
+        b_growth = false;
+      }
+    }
+
+    rates[i] = d_rate;
+
+  }
+
+  gsl_vector_free( p_abundances );
+  gsl_vector_free( p_ydot );
+
+  for( size_t k = 0; k < I_HYDRO_TRIALS; k++ )
+  {
+    double d_change = hydro_change( d_h );
+    if( d_change <= dRegX ) break;
+    d_h *= std::max( D_PI_MIN_FACTOR, D_HYDRO_SAFETY * dRegX / d_change );
+    b_growth = false;
+  }
+
+  if( b_growth ) iGrowthLimited++;
+
+  d_dt = d_h;
+
+}
+
+//##############################################################################
+// step_controller::pi().  The abundance changes are those of the last step,
+// the same ones Libnucnet__Zone__updateTimeStep() uses.
+//##############################################################################
+
+void
+step_controller::pi( nnt::Zone& zone, double& d_dt, double d_hydro_error )
+{
+
+  gsl_vector * p_abundances =
+    Libnucnet__Zone__getAbundances( zone.getNucnetZone() );
+  gsl_vector * p_changes =
+    Libnucnet__Zone__getAbundanceChanges( zone.getNucnetZone() );
+  const double * p_y = p_abundances->data;
+  const double * p_dy = p_changes->data;
+  double d_error = d_hydro_error;
+
+  for( size_t i = 0; i < p_abundances->size; i++ )
+  {
+    if( p_y[i] > dYMin )
+      d_error = std::max( d_error, fabs( p_dy[i] ) / ( p_y[i] * dRegY ) );
+  }
+
+  gsl_vector_free( p_abundances );
+  gsl_vector_free( p_changes );
+
+  d_error = std::max( d_error, 1.e-10 );
+
+  if( iHistory++ == 0 ) dErrorLast = d_error;
+
+  double d_factor =
+    D_PI_SAFETY *
+    pow( 1. / d_error, dKI ) *
+    pow( dErrorLast / d_error, dKP );
+
+  if( d_factor >= dGrowth )
+  {
+    d_factor = dGrowth;
+    iGrowthLimited++;
+  }
+
+  d_dt *= std::max( d_factor, D_PI_MIN_FACTOR );
+
+  dErrorLast = d_error;
+
+}
+
+//##############################################################################
+// step_controller::operator()().  The hydro forecast is only used by the
+// predictive controller, and the hydro error ratio only by the PI
+// controller.
+//##############################################################################
+
+void
+step_controller::operator()(
+  nnt::Zone& zone,
+  double& d_dt,
+  const boost::function<double( double )>& hydro_change,
+  double d_hydro_error
+)
+{
+
+  double d_dt_old = d_dt;
+
+  iSteps++;
+
+  if( sMode == S_DT_PREDICTIVE )
+    predict( zone, d_dt, hydro_change );
+  else if( sMode == S_DT_PI )
+    pi( zone, d_dt, d_hydro_error );
+  else
+    Libnucnet__Zone__updateTimeStep(
+      zone.getNucnetZone(), &d_dt, dRegT, dRegY, dYMin
+    );
+
+  if( d_dt > 0 && d_dt_old > 0 )
+    dLogRatioSum += fabs( log( d_dt / d_dt_old ) );
+
+}
+
+//##############################################################################
+// step_controller::report().
+//##############################################################################
+
+void
+step_controller::report( std::ostream& os ) const
+{
+
+  os <<
+    boost::format( "\nTime step controller (%s): %lu steps" ) %
+    sMode % iSteps;
+
+  if( sMode != S_DT_STANDARD )
+    os <<
+      boost::format( ", %lu limited by the growth factor" ) % iGrowthLimited;
+
+  if( iSteps )
+    os <<
+      boost::format( ", mean |ln(dt ratio)| = %.4f" ) %
+      ( dLogRatioSum / iSteps );
+
+  os << "\n\n";
+
+}
+
+}  // namespace my_user
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file my_timestep_helper.h
+//! \brief A header file to define time step helper routines.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MY_TIMESTEP_HELPER_H
+#define MY_TIMESTEP_HELPER_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/function.hpp>
+#include <boost/program_options.hpp>
+
+#include <gsl/gsl_math.h>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+
+#define S_DT_CONTROLLER   "dt_controller"
+#define S_DT_STANDARD     "standard"
+#define S_DT_PREDICTIVE   "predictive"
+#define S_DT_PI           "pi"
+#define S_DT_GROWTH       "dt_growth"
+#define S_PI_KI           "pi_ki"
+#define S_PI_KP           "pi_kp"
+
+#define D_PI_SAFETY       0.9     /* Safety factor for the PI controller */
+#define D_PI_MIN_FACTOR   0.2     /* Smallest PI step change factor */
+#define D_HYDRO_SAFETY    0.9     /* Safety factor for the hydro forecast */
+#define I_HYDRO_TRIALS    10      /* Most hydro forecasts per step */
+
+namespace po = boost::program_options;
+
+/**
+ * @brief A namespace for user-defined functions.
+ */
+namespace my_user
+{
+
+typedef std::map<std::string, boost::any> param_map_t;
+
+//##############################################################################
+// step_controller.
+//##############################################################################
+
+/**
+ * @brief A class to choose the next network time step.
+ *
+ * The standard controller is Libnucnet__Zone__updateTimeStep().  The
+ * predictive controller takes each abundance's relative rate of change from
+ * the zone's flow vector at the end of the step, and its rate of change from
+ * the same rate at the end of the step before.  It takes the largest step
+ * over which no abundance above the minimum is forecast to change by more
+ * than the abundance regulator to second order.  The hydro forecast, the
+ * largest relative change of T9 and rho over a proposed step, must then stay
+ * within the hydro regulator; the step is cut until it does.  Growth per
+ * step is capped by the growth factor.
+ *
+ * The PI controller (Gustafsson) takes the error ratio as the larger of the
+ * largest relative abundance change over the abundance regulator and the
+ * hydro error ratio passed in, and sets
+ * h_{n+1} = h_n * s * (1/r_n)^kI * (r_{n-1}/r_n)^kP.  It replaces both the
+ * abundance and the hydro limits on the step.
+ */
+
+class step_controller
+{
+
+  public:
+    step_controller(
+      const std::string&, double, double, double, double, double,
+      double = 0, double = 0
+    );
+
+    void
+    operator()(
+      nnt::Zone&, double&, const boost::function<double( double )>&, double
+    );
+    bool controlsHydro() const { return sMode == S_DT_PI; }
+    void report( std::ostream& ) const;
+
+  private:
+    std::string sMode;
+    double dRegT, dRegY, dRegX, dYMin, dGrowth, dKI, dKP;
+    size_t iSteps, iHistory, iGrowthLimited;
+    double dErrorLast, dLogRatioSum;
+    std::vector<double> rates;
+
+    void
+    predict( nnt::Zone&, double&, const boost::function<double( double )>& );
+    void pi( nnt::Zone&, double&, double );
+
+    static double horizon( double, double, double );
+
+};
+
+//##############################################################################
+// Prototypes.
+//##############################################################################
+
+void
+get_timestep_descriptions( po::options_description& );
+
+void
+set_timestep_options( po::variables_map&, param_map_t& );
+
+} // namespace my_user
+
+#endif // MY_TIMESTEP_HELPER_H
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \brief Code to print out the binary abundance log written by run_entropy.
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <boost/format.hpp>
+
+#include "my_abundance_log_record.h"
+
+//##############################################################################
+// get().
+//##############################################################################
+
+template<typename T>
+bool get( std::FILE * p_file, T& t )
+{
+  return std::fread( &t, sizeof( T ), 1, p_file ) == 1;
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int main( int argc, char * argv[] ) {
+
+  std::FILE * p_file;
+  char s_magic[sizeof( S_ABUNDANCE_LOG_MAGIC )] = "";
+  my_user::abundance_log_count_t i_species, i_index, i_z, i_a, i_len, i_count;
+  my_user::abundance_log_label_t i_label;
+  double d_t, d_t9, d_rho, d_s, d_y;
+  std::map<
+    my_user::abundance_log_count_t,
+    std::pair<std::string, my_user::abundance_log_count_t>
+  > species_map;
+
+  if( argc != 2 )
+  {
+    std::cerr << "\nUsage: " << argv[0] << " abundance_log\n\n" <<
+      "  abundance_log = binary abundance log from run_entropy\n\n";
+    exit( EXIT_FAILURE );
+  }
+
+  p_file = std::fopen( argv[1], "rb" );
+
+  if( !p_file )
+  {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  //============================================================================
+  // Read header.
+  //============================================================================
+
+  if(
+    std::fread( s_magic, 1, strlen( S_ABUNDANCE_LOG_MAGIC ), p_file ) !=
+      strlen( S_ABUNDANCE_LOG_MAGIC ) ||
+    strcmp( s_magic, S_ABUNDANCE_LOG_MAGIC ) != 0 ||
+    !get( p_file, i_species )
+  )
+  {
+    std::cerr << "Not a valid abundance log." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  for( my_user::abundance_log_count_t i = 0; i < i_species; i++ )
+  {
+    if(
+      !get( p_file, i_index ) || !get( p_file, i_z ) ||
+      !get( p_file, i_a ) || !get( p_file, i_len )
+    )
+    {
+      std::cerr << "Truncated abundance log header." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+    std::string s_name( i_len, ' ' );
+    if( i_len && std::fread( &s_name[0], 1, i_len, p_file ) != i_len )
+    {
+      std::cerr << "Truncated abundance log header." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+    species_map[i_index] = std::make_pair( s_name, i_a );
+  }
+
+  //============================================================================
+  // Print records.
+  //============================================================================
+
+  while( get( p_file, i_label ) )
+  {
+
+    if(
+      !get( p_file, d_t ) || !get( p_file, d_t9 ) || !get( p_file, d_rho ) ||
+      !get( p_file, d_s ) || !get( p_file, i_count )
+    )
+      break;
+
+    std::cout <<
+      boost::format(
+        "step = %d t = %.5e t9 = %.5e rho = %.5e s = %.5e\n"
+      ) % i_label % d_t % d_t9 % d_rho % d_s;
+
+    for( my_user::abundance_log_count_t i = 0; i < i_count; i++ )
+    {
+      if( !get( p_file, i_index ) || !get( p_file, d_y ) ) break;
+      std::cout <<
+        boost::format( "%-8s %.5e %.5e\n" ) %
+        species_map[i_index].first %
+        d_y %
+        ( species_map[i_index].second * d_y );
+    }
+
+    std::cout << std::endl;
+
+  }
+
+  std::fclose( p_file );
+
+  return EXIT_SUCCESS;
+
+}
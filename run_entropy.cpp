@@ -44,7 +44,20 @@
 #include "user/flow_utilities.h"
 #include "user/hydro_helper.h"
 
+#include "my_checkpoint_helper.h"
+#include "my_cost_helper.h"
+#include "my_decay_helper.h"
+#include "my_event_helper.h"
+#include "my_evolve_helper.h"
+#include "my_flow_helper.h"
+#include "my_freezeout_helper.h"
 #include "my_hydro_helper.h"
+#include "my_limiter_helper.h"
+#include "my_log_helper.h"
+#include "my_output_helper.h"
+#include "my_progress_helper.h"
+#include "my_t9_helper.h"
+#include "my_timestep_helper.h"
 
 typedef my_user::state_type my_state_type;
 
@@ -260,6 +273,38 @@ class entropy_generation_rhs
       
 }; 
 
+//##############################################################################
+// hydro_rhs.  The expansion alone, with the entropy held fixed, for a
+// decay-only jump.
+//##############################################################################
+
+class hydro_rhs
+{
+  nnt::Zone& zone;
+
+  public:
+    hydro_rhs( nnt::Zone& _zone ) : zone( _zone ) {}
+
+    void operator()(
+      const my_state_type &x, my_state_type &dxdt, const double d_t
+    )
+    {
+
+      dxdt[0] = x[1];
+
+      dxdt[1] =
+        boost::any_cast<
+          boost::function<double( const my_state_type&, const double )>
+        >(
+          zone.getFunction( S_ACCELERATION_FUNCTION )
+        )( x, d_t );
+
+      dxdt[2] = 0;
+
+    }
+
+};
+
 //##############################################################################
 // program_options().
 //##############################################################################
@@ -376,7 +421,8 @@ get_input( int argc, char **argv )
       (
        S_OBSERVE,
        po::value<std::string>()->default_value( "no" ),
-       "Observe steps"
+       "Observe steps (no, yes = print, or ring = record to the observer"
+       " file)"
       )
 
       ( S_RESPONSE_FILE, po::value<std::string>(),
@@ -385,6 +431,32 @@ get_input( int argc, char **argv )
 
     ;
 
+    my_user::get_output_descriptions( general );
+
+    my_user::get_log_descriptions( general );
+
+    my_user::get_flow_descriptions( general );
+
+    my_user::get_limiter_descriptions( general );
+
+    my_user::get_timestep_descriptions( general );
+
+    my_user::get_t9_descriptions( general );
+
+    my_user::get_evolve_descriptions( general );
+
+    my_user::get_decay_descriptions( general );
+
+    my_user::get_freezeout_descriptions( general );
+
+    my_user::get_event_descriptions( general );
+
+    my_user::get_progress_descriptions( general );
+
+    my_user::get_checkpoint_descriptions( general );
+
+    my_user::get_cost_descriptions( general );
+
     po::options_description network("\nNetwork options");
     network.add_options()
       (
@@ -573,8 +645,77 @@ get_input( int argc, char **argv )
       vm[nnt::s_USE_NSE_CORRECTION].as<std::string>();
     param_map[S_T9_GUESS] = vm[S_T9_GUESS].as<std::string>();
     param_map[S_OBSERVE] = vm[S_OBSERVE].as<std::string>();
+
+    if(
+      boost::any_cast<std::string>( param_map[S_OBSERVE] ) != "no" &&
+      boost::any_cast<std::string>( param_map[S_OBSERVE] ) != "yes" &&
+      boost::any_cast<std::string>( param_map[S_OBSERVE] ) != "ring"
+    )
+    {
+      std::cerr << "Observe must be no, yes, or ring." << std::endl;
+      exit( EXIT_FAILURE );
+    }
     param_map[nnt::s_MU_NUE_KT] = vm[nnt::s_MU_NUE_KT].as<std::string>();
 
+    my_user::set_output_options( vm, param_map );
+
+    my_user::set_log_options( vm, param_map );
+
+    if(
+      boost::any_cast<std::string>( param_map[S_OBSERVE] ) == "ring" &&
+      param_map.find( S_OBSERVER_FILE ) == param_map.end()
+    )
+    {
+      std::cerr << "Observe ring needs an observer file." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+
+    my_user::set_flow_options( vm, param_map );
+
+    my_user::set_limiter_options( vm, param_map );
+
+    my_user::set_timestep_options( vm, param_map );
+
+    my_user::set_t9_options( vm, param_map );
+
+    my_user::set_evolve_options( vm, param_map );
+
+    my_user::set_decay_options( vm, param_map );
+
+    my_user::set_freezeout_options( vm, param_map );
+
+    my_user::set_event_options( vm, param_map );
+
+    my_user::set_progress_options( vm, param_map );
+
+    my_user::set_checkpoint_options( vm, param_map );
+
+    if(
+      param_map.find( S_RESTART ) != param_map.end() &&
+      (
+        boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+          S_OUTPUT_SUMMARY ||
+        boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+          S_OUTPUT_STORE ||
+        param_map.find( S_FLOW_OUTPUT ) != param_map.end() ||
+        boost::any_cast<size_t>( param_map[S_SDOT_TOP_K] ) > 0 ||
+        !boost::any_cast<std::vector<double> >( param_map[S_EVENT_T9] ).empty()
+        ||
+        !boost::any_cast<std::vector<double> >( param_map[S_EVENT_RHO] ).empty()
+        ||
+        boost::any_cast<std::string>( param_map[S_EVENT_SDOT_PEAK] ) == "yes"
+      )
+    )
+    {
+      std::cerr <<
+        "Restart does not work with summary or store output, flow output,"
+        " the entropy breakdown, or events, since the checkpoint does not"
+        " hold what they have gathered." << std::endl;
+      exit( EXIT_FAILURE );
+    }
+
+    my_user::set_cost_options( vm, param_map );
+
     // Set user-defined options
     my_user::set_user_defined_options( vm, param_map );
 
@@ -594,20 +735,151 @@ get_input( int argc, char **argv )
 
 }
 
+//##############################################################################
+// hydro_change().  The forecast largest relative change of rho and T9 over a
+// step of d_h from t.  Rho comes from the rho function at the expansion
+// state advanced to second order, and T9 from the T9 predictor, if there is
+// one.
+//##############################################################################
+
+double
+hydro_change(
+  nnt::Zone& zone,
+  const my_state_type& x,
+  const my_user::t9_predictor * p_t9_predictor,
+  double d_t,
+  double d_h
+)
+{
+
+  boost::function<double( const my_state_type& )> rho_func =
+    boost::any_cast<boost::function<double( const my_state_type& )> >(
+      zone.getFunction( S_RHO_FUNCTION )
+    );
+
+  my_state_type x_ahead( x );
+
+  x_ahead[0] +=
+    d_h *
+    (
+      x[1] +
+      0.5 * d_h *
+      boost::any_cast<
+        boost::function<double( const my_state_type&, const double )>
+      >(
+        zone.getFunction( S_ACCELERATION_FUNCTION )
+      )( x, d_t )
+    );
+
+  double d_rho = rho_func( x );
+  double d_change = fabs( rho_func( x_ahead ) - d_rho ) / d_rho;
+
+  if( p_t9_predictor )
+  {
+    double d_t9 = zone.getProperty<double>( nnt::s_T9 );
+    d_change =
+      GSL_MAX(
+        d_change,
+        fabs( p_t9_predictor->extrapolate( d_t + d_h ) - d_t9 ) / d_t9
+      );
+  }
+
+  return d_change;
+
+}
+
+//##############################################################################
+// write_dump().
+//##############################################################################
+
+void
+write_dump(
+  Libnucnet * p_my_nucnet,
+  nnt::Zone& zone,
+  int k,
+  my_user::abundance_log * p_abundance_log,
+  my_user::snapshot_writer * p_snapshot_writer,
+  my_user::snapshot_store * p_store,
+  Libnucnet * p_my_output,
+  const char * s_output,
+  int i_level
+)
+{
+
+  char s_property[32];
+
+  sprintf( s_property, "%d", k );
+  Libnucnet__relabelZone(
+    p_my_nucnet,
+    zone.getNucnetZone(),
+    s_property,
+    NULL,
+    NULL
+  );
+  if( my_user::log_enabled( my_user::LOG_DEBUG ) )
+  {
+    nnt::print_zone_abundances( zone );
+  }
+  if( p_abundance_log )
+  {
+    p_abundance_log->write( zone, k );
+  }
+  if( p_snapshot_writer )
+  {
+    p_snapshot_writer->write( zone );
+  }
+  else if( p_store )
+  {
+    p_store->add( zone );
+  }
+  else if( p_my_output )
+  {
+    nnt::write_xml( p_my_output, zone.getNucnetZone() );
+    if( B_OUTPUT_EVERY_TIME_DUMP )
+    {
+      my_user::write_xml_output( p_my_output, s_output, i_level );
+    }
+  }
+
+}
+
 //##############################################################################
 // main().
 //##############################################################################
 
 int main( int argc, char * argv[] ) {
 
+  double d_wall_start = my_user::wall_time();
   int k = 0;
   size_t i_step = 0;
-  double d_t, d_dt, d_t9_old, d_dt9dt;
+  double d_t, d_dt;
   my_user::param_map_t param_map;
-  Libnucnet * p_my_nucnet, * p_my_output;
+  Libnucnet * p_my_nucnet, * p_my_output = NULL;
+  my_user::snapshot_writer * p_snapshot_writer = NULL;
+  my_user::trajectory_summary * p_summary = NULL;
+  my_user::snapshot_store * p_store = NULL;
+  my_user::abundance_log * p_abundance_log = NULL;
+  my_user::reaction_index * p_reaction_index = NULL;
+  my_user::step_flows * p_step_flows = NULL;
+  my_user::flow_accumulator * p_flows = NULL;
+  my_user::sdot_breakdown * p_sdot_breakdown = NULL;
+  my_user::adaptive_sdot * p_adaptive_sdot = NULL;
+  my_user::network_limiter * p_limiter = NULL;
+  my_user::step_controller * p_step_controller = NULL;
+  my_user::t9_predictor * p_t9_predictor = NULL;
+  my_user::network_evolver * p_evolver = NULL;
+  my_user::decay_solver * p_decay = NULL;
+  my_user::freezeout_detector * p_freezeout = NULL;
+  my_user::event_locator * p_events = NULL;
+  my_user::observer_ring * p_observer = NULL;
+  my_user::progress_publisher * p_progress = NULL;
+  my_user::walltime_budget * p_budget = NULL;
+  my_user::cost_model * p_cost = NULL;
+  std::string s_checkpoint;
+  bool b_decay = false, b_frozen = false, b_stop = false, b_checkpoint = false;
+  bool b_estimate;
   Libnucnet__NetView * p_view = NULL;
   nnt::Zone zone;
-  char s_property[32];
   std::set<std::string> isolated_species_set;
 
   my_state_type
@@ -707,7 +979,7 @@ int main( int argc, char * argv[] ) {
 
 //    Careful that you don't remove a species with non-zero abundance!
 
-      std::cout << s_species << std::endl;
+      my_user::log_message( my_user::LOG_INFO, s_species );
 
       Libnucnet__Nuc__removeSpecies(
         Libnucnet__Net__getNuc( Libnucnet__getNet( p_my_nucnet ) ),
@@ -769,7 +1041,8 @@ int main( int argc, char * argv[] ) {
         my_user::t9_function,
         boost::ref( zone ),
         boost::ref( param_map ),
-        _1
+        _1,
+        0.
       )
     )
   );
@@ -820,6 +1093,59 @@ int main( int argc, char * argv[] ) {
     )
   );
 
+  if( boost::any_cast<std::string>( param_map[S_EVOLVER] ) == S_EVOLVER_BDF )
+  {
+
+    p_evolver =
+      new my_user::bdf_evolver(
+        zone,
+        boost::any_cast<double>( param_map[S_EVOLVER_RTOL] ),
+        boost::any_cast<double>( param_map[S_EVOLVER_ATOL] ),
+        boost::any_cast<size_t>( param_map[S_BDF_MAX_ORDER] )
+      );
+
+  }
+  else if(
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) ==
+      S_EVOLVER_ROSENBROCK
+  )
+  {
+
+    p_evolver =
+      new my_user::rosenbrock_evolver(
+        zone,
+        boost::any_cast<double>( param_map[S_EVOLVER_RTOL] ),
+        boost::any_cast<double>( param_map[S_EVOLVER_ATOL] ),
+        boost::any_cast<std::string>( param_map[S_ROSENBROCK_SOLVER] ) ==
+          S_ROSENBROCK_DENSE
+      );
+
+  }
+  else if(
+    boost::any_cast<std::string>( param_map[S_EVOLVER] ) == S_EVOLVER_JFNK
+  )
+  {
+
+    p_evolver =
+      new my_user::jfnk_evolver(
+        zone,
+        boost::any_cast<double>( param_map[S_EVOLVER_RTOL] ),
+        boost::any_cast<double>( param_map[S_EVOLVER_ATOL] ),
+        S_JFNK_BORDER
+      );
+
+  }
+
+  if( p_evolver )
+  {
+    zone.updateFunction(
+      S_EVOLVE_FUNCTION,
+      static_cast<boost::function<void( Libnucnet__NetView *, const double )> >(
+        boost::bind<void>( boost::ref( *p_evolver ), _1, _2 )
+      )
+    );
+  }
+
   //============================================================================
   // Set the observer function with basic prototype
   //   void( const my_state_type& x, const my_state_type& dxdt, const double t )
@@ -847,6 +1173,29 @@ int main( int argc, char * argv[] ) {
       )
     );
   }
+  else if( boost::any_cast<std::string>( param_map[S_OBSERVE] ) == "ring" )
+  {
+    p_observer =
+      new my_user::observer_ring(
+        zone,
+        boost::any_cast<std::string>( param_map[S_OBSERVER_FILE] ),
+        boost::any_cast<size_t>( param_map[S_OBSERVER_SIZE] ),
+        boost::any_cast<size_t>( param_map[S_OBSERVER_SAMPLE] ),
+        param_map.find( S_RESTART ) != param_map.end()
+      );
+    zone.updateFunction(
+      S_OBSERVER_FUNCTION,
+      static_cast<
+        boost::function<
+          void(
+            const my_state_type&,
+            const my_state_type&,
+            const double
+          )
+        >
+      >( boost::bind<void>( boost::ref( *p_observer ), _1, _2, _3 ) )
+    );
+  }
             
   //============================================================================
   // Sort the nuclei if using the arrow solver.
@@ -871,20 +1220,117 @@ int main( int argc, char * argv[] ) {
   }
 
   //============================================================================
-  // Create output.
+  // Create output.  A cost estimate only runs the probe steps, so it writes
+  // none.
   //============================================================================
 
-  p_my_output = nnt::create_network_copy( p_my_nucnet );
+  b_estimate =
+    boost::any_cast<std::string>( param_map[S_COST_ESTIMATE] ) == "yes";
 
-  Libnucnet__setZoneCompareFunction(
-    p_my_output,
-    (Libnucnet__Zone__compare_function) nnt::zone_compare_by_first_label
-  );
+  if( b_estimate )
+  {
+    my_user::log_message(
+      my_user::LOG_INFO, "Estimating the cost; no output will be written."
+    );
+  }
+  else if(
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+      S_OUTPUT_SNAPSHOT
+  )
+  {
 
-  Libnucnet__updateZoneXmlMassFractionFormat(
-    p_my_output,
-    "%.15e"
-  );
+    std::set<std::string> step_set =
+      boost::assign::list_of
+        ( nnt::s_TIME )( nnt::s_DTIME )( nnt::s_T9 )( nnt::s_RHO )
+        ( nnt::s_ENTROPY_PER_NUCLEON )( S_X );
+
+    p_snapshot_writer =
+      new my_user::snapshot_writer(
+        argv[3],
+        Libnucnet__getNet( p_my_nucnet ),
+        step_set,
+        boost::any_cast<std::string>( param_map[S_MASS_FRACTION_FORMAT] ),
+        boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+      );
+
+  }
+  else if(
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) ==
+      S_OUTPUT_SUMMARY
+  )
+  {
+    p_summary = new my_user::trajectory_summary();
+  }
+  else if(
+    boost::any_cast<std::string>( param_map[S_OUTPUT_MODE] ) == S_OUTPUT_STORE
+  )
+  {
+
+    p_store =
+      new my_user::snapshot_store(
+        Libnucnet__getNet( p_my_nucnet ),
+        boost::any_cast<std::string>( param_map[S_MASS_FRACTION_FORMAT] ),
+        boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+      );
+
+  }
+  else
+  {
+
+    p_my_output = nnt::create_network_copy( p_my_nucnet );
+
+    Libnucnet__setZoneCompareFunction(
+      p_my_output,
+      (Libnucnet__Zone__compare_function) nnt::zone_compare_by_first_label
+    );
+
+    Libnucnet__updateZoneXmlMassFractionFormat(
+      p_my_output,
+      my_user::printf_mass_fraction_format(
+        boost::any_cast<std::string>( param_map[S_MASS_FRACTION_FORMAT] )
+      ).c_str()
+    );
+
+  }
+
+  if( !b_estimate && param_map.find( S_ABUNDANCE_LOG ) != param_map.end() )
+  {
+    p_abundance_log =
+      new my_user::abundance_log(
+        boost::any_cast<std::string>( param_map[S_ABUNDANCE_LOG] ),
+        Libnucnet__getNet( p_my_nucnet ),
+        param_map.find( S_RESTART ) != param_map.end()
+      );
+  }
+
+  if(
+    param_map.find( S_FLOW_OUTPUT ) != param_map.end() ||
+    boost::any_cast<size_t>( param_map[S_SDOT_TOP_K] ) > 0 ||
+    boost::any_cast<double>( param_map[S_SDOT_TOLERANCE] ) > 0
+  )
+  {
+    p_reaction_index =
+      new my_user::reaction_index( Libnucnet__getNet( p_my_nucnet ) );
+  }
+
+  if( !b_estimate && param_map.find( S_FLOW_OUTPUT ) != param_map.end() )
+  {
+    p_flows = new my_user::flow_accumulator( *p_reaction_index );
+  }
+
+  if( boost::any_cast<size_t>( param_map[S_SDOT_TOP_K] ) > 0 )
+  {
+    p_sdot_breakdown =
+      new my_user::sdot_breakdown(
+        *p_reaction_index,
+        boost::any_cast<size_t>( param_map[S_SDOT_TOP_K] )
+      );
+  }
+
+  if( p_flows || p_sdot_breakdown )
+  {
+    p_step_flows = new my_user::step_flows( *p_reaction_index );
+  }
 
   //============================================================================
   // Initialize the system.
@@ -900,10 +1346,6 @@ int main( int argc, char * argv[] ) {
     boost::any_cast<double>( param_map[nnt::s_RHO_0] )
   );
 
-  d_t9_old = zone.getProperty<double>( nnt::s_T9 );
-
-  d_dt9dt = 0;
-  
   zone.updateProperty( nnt::s_PARTICLE, S_PARTICLE);
 
   d_dt = boost::any_cast<double>( param_map[nnt::s_DTIME] );
@@ -917,7 +1359,179 @@ int main( int argc, char * argv[] ) {
       zone.getFunction( S_ENTROPY_FUNCTION )
     )( );
 
-  user::limit_evolution_network( zone, D_LIM_CUTOFF );
+  //============================================================================
+  // Resume from a checkpoint if desired.  The stepper and the helpers start
+  // fresh from the restored state.
+  //============================================================================
+
+  if( param_map.find( S_RESTART ) != param_map.end() )
+  {
+    my_user::read_checkpoint(
+      boost::any_cast<std::string>( param_map[S_RESTART] ),
+      zone,
+      x,
+      d_t,
+      d_dt,
+      k,
+      i_step,
+      b_frozen
+    );
+    my_user::log_message(
+      my_user::LOG_INFO,
+      ( boost::format( "Restarting at t = %g" ) % d_t ).str()
+    );
+  }
+
+  if( boost::any_cast<std::string>( param_map[S_T9_GUESS] ) == "yes" )
+  {
+    p_t9_predictor =
+      new my_user::t9_predictor(
+        boost::any_cast<size_t>( param_map[S_T9_GUESS_ORDER] )
+      );
+    p_t9_predictor->update( d_t, zone.getProperty<double>( nnt::s_T9 ) );
+  }
+
+  p_limiter =
+    new my_user::network_limiter(
+      Libnucnet__getNet( p_my_nucnet ),
+      D_LIM_CUTOFF,
+      boost::any_cast<std::string>( param_map[S_LIMITER_MODE] ),
+      boost::any_cast<std::string>( param_map[S_LIMITER_SKIP] ) == "yes"
+    );
+
+  (*p_limiter)( zone );
+
+  //============================================================================
+  // Replace the entropy generation function with the adaptive one if a
+  // tolerance is set.  Its checks follow the limiter's rebuilds.
+  //============================================================================
+
+  if( boost::any_cast<double>( param_map[S_SDOT_TOLERANCE] ) > 0 )
+  {
+
+    p_adaptive_sdot =
+      new my_user::adaptive_sdot(
+        *p_reaction_index,
+        boost::any_cast<double>( param_map[S_SDOT_TOLERANCE] ),
+        boost::any_cast<size_t>( param_map[S_SDOT_CHECK_INTERVAL] ),
+        boost::any_cast<double>( param_map[S_SDOT_CHECK_THRESHOLD] ),
+        boost::bind( &my_user::network_limiter::generation, p_limiter )
+      );
+
+    zone.updateFunction(
+      S_ENTROPY_GENERATION_FUNCTION,
+      static_cast<boost::function<double( Libnucnet__NetView * )> >(
+        boost::bind<double>(
+          boost::ref( *p_adaptive_sdot ),
+          boost::ref( zone ),
+          _1
+        )
+      )
+    );
+
+  }
+
+  if(
+    b_estimate || param_map.find( S_TIMING_LOG ) != param_map.end()
+  )
+  {
+    p_cost =
+      new my_user::cost_model(
+        boost::any_cast<size_t>( param_map[S_COST_PROBE_STEPS] ),
+        boost::any_cast<double>( param_map[nnt::s_TEND] )
+      );
+    p_cost->probe_network( zone.getNetView( EVOLUTION_NETWORK ) );
+    p_cost->probe_expansion( x );
+  }
+
+  p_step_controller =
+    new my_user::step_controller(
+      boost::any_cast<std::string>( param_map[S_DT_CONTROLLER] ),
+      D_REG_T,
+      D_REG_Y,
+      D_X_REG_T,
+      D_Y_MIN_DT,
+      boost::any_cast<double>( param_map[S_DT_GROWTH] ),
+      boost::any_cast<double>( param_map[S_PI_KI] ),
+      boost::any_cast<double>( param_map[S_PI_KP] )
+    );
+
+  if(
+    !boost::any_cast<std::vector<double> >( param_map[S_EVENT_T9] ).empty() ||
+    !boost::any_cast<std::vector<double> >( param_map[S_EVENT_RHO] ).empty() ||
+    boost::any_cast<std::string>( param_map[S_EVENT_SDOT_PEAK] ) == "yes"
+  )
+  {
+    p_events =
+      new my_user::event_locator(
+        boost::any_cast<std::vector<double> >( param_map[S_EVENT_T9] ),
+        boost::any_cast<std::vector<double> >( param_map[S_EVENT_RHO] ),
+        boost::any_cast<std::string>( param_map[S_EVENT_SDOT_PEAK] ) == "yes"
+      );
+    zone.updateProperty( nnt::s_TIME, d_t );
+    zone.updateProperty( nnt::s_ENTROPY_PER_NUCLEON, x[2] );
+    p_events->update( zone );
+  }
+
+  if( param_map.find( S_PROGRESS_DIR ) != param_map.end() )
+  {
+    p_progress =
+      new my_user::progress_publisher(
+        boost::any_cast<std::string>( param_map[S_PROGRESS_DIR] ),
+        boost::any_cast<double>( param_map[nnt::s_TEND] ),
+        argv[3]
+      );
+  }
+
+  if( boost::any_cast<size_t>( param_map[S_FREEZEOUT_WINDOW] ) > 0 )
+  {
+    p_freezeout =
+      new my_user::freezeout_detector(
+        boost::any_cast<size_t>( param_map[S_FREEZEOUT_WINDOW] ),
+        boost::any_cast<double>( param_map[S_FREEZEOUT_YDOT] ),
+        boost::any_cast<double>( param_map[S_FREEZEOUT_SDOT] )
+      );
+  }
+
+  //============================================================================
+  // A decay-only jump leaves only the end-of-jump flows, so the flow totals
+  // and the entropy breakdown would be wrong over it.  Runs with either keep
+  // stepping.
+  //============================================================================
+
+  if(
+    boost::any_cast<double>( param_map[S_DECAY_T9] ) > 0 ||
+    (
+      p_freezeout &&
+      boost::any_cast<std::string>( param_map[S_FREEZEOUT_ACTION] ) ==
+        S_FREEZEOUT_DECAY
+    )
+  )
+  {
+    if( p_flows || p_sdot_breakdown )
+      my_user::log_message(
+        my_user::LOG_WARN,
+        "Decay jumps are off with flow output or the entropy breakdown."
+      );
+    else
+      p_decay =
+        new my_user::decay_solver(
+          Libnucnet__getNet( p_my_nucnet ),
+          boost::any_cast<double>( param_map[S_DECAY_TOLERANCE] )
+        );
+  }
+
+  if( param_map.find( S_CHECKPOINT_FILE ) != param_map.end() )
+    s_checkpoint = boost::any_cast<std::string>( param_map[S_CHECKPOINT_FILE] );
+  else
+    s_checkpoint = std::string( argv[3] ) + S_CHECKPOINT_SUFFIX;
+
+  p_budget =
+    new my_user::walltime_budget(
+      d_wall_start,
+      boost::any_cast<double>( param_map[S_WALLTIME] ),
+      boost::any_cast<double>( param_map[S_WALLTIME_MARGIN] )
+    );
 
   //============================================================================
   // Choose the stepper.
@@ -958,9 +1572,46 @@ int main( int argc, char * argv[] ) {
     else
       p_sdot_view = zone.getNetView( EVOLUTION_NETWORK );
 
-    entropy_generation_rhs my_rhs( zone, p_sdot_view );
+    if(
+      p_decay &&
+      (
+        b_frozen ||
+        zone.getProperty<double>( nnt::s_T9 ) <
+          boost::any_cast<double>( param_map[S_DECAY_T9] )
+      ) &&
+      p_decay->check(
+        zone,
+        zone.getNetView( EVOLUTION_NETWORK ),
+        boost::any_cast<boost::function<double( Libnucnet__NetView * )> >(
+          zone.getFunction( S_ENTROPY_GENERATION_FUNCTION )
+        )( p_sdot_view ),
+        x[2],
+        boost::any_cast<double>( param_map[nnt::s_TEND] ) - d_t
+      )
+    )
+    {
+
+      b_decay = true;
+
+      boost::numeric::odeint::integrate(
+        hydro_rhs( zone ),
+        x,
+        d_t,
+        boost::any_cast<double>( param_map[nnt::s_TEND] ),
+        d_dt
+      );
+
+      d_dt = boost::any_cast<double>( param_map[nnt::s_TEND] ) - d_t;
+
+    }
+    else
+    {
+
+      entropy_generation_rhs my_rhs( zone, p_sdot_view );
 
-    stepper.do_step( my_rhs, x, d_t, d_dt );
+      stepper.do_step( my_rhs, x, d_t, d_dt );
+
+    }
 
   //============================================================================
   // Update properties.
@@ -985,11 +1636,11 @@ int main( int argc, char * argv[] ) {
       x[2]
     );
 
-    if( boost::any_cast<std::string>( param_map[S_T9_GUESS] ) == "yes" )
+    if( p_t9_predictor && !b_decay )
     {
       zone.updateProperty(
         nnt::s_T9,
-        d_t9_old + d_dt9dt * d_dt
+        p_t9_predictor->predict( d_t )
       );
     }
 
@@ -998,26 +1649,91 @@ int main( int argc, char * argv[] ) {
       my_user::t9_function(
         zone,
         param_map,
-        zone.getNetView( EVOLUTION_NETWORK )
+        zone.getNetView( EVOLUTION_NETWORK ),
+        p_t9_predictor ? p_t9_predictor->width() : 0.
       )
     );
 
-    if( boost::any_cast<std::string>( param_map[S_T9_GUESS] ) == "yes" )
+    if( p_t9_predictor )
     {
-      d_dt9dt = ( zone.getProperty<double>( nnt::s_T9 ) - d_t9_old ) / d_dt;
-      d_t9_old = zone.getProperty<double>( nnt::s_T9 );
+      p_t9_predictor->update( d_t, zone.getProperty<double>( nnt::s_T9 ) );
     }
 
-    boost::any_cast<
-      boost::function<void( Libnucnet__NetView *, const double )>
-    >(
-      zone.getFunction( S_EVOLVE_FUNCTION )
-    )( zone.getNetView( EVOLUTION_NETWORK ), d_dt );
+    if( b_decay )
+    {
+      p_decay->evolve( zone, d_dt );
+    }
+    else
+    {
+      boost::any_cast<
+        boost::function<void( Libnucnet__NetView *, const double )>
+      >(
+        zone.getFunction( S_EVOLVE_FUNCTION )
+      )( zone.getNetView( EVOLUTION_NETWORK ), d_dt );
+    }
 
     zone.updateProperty( S_X, "0", x[0] );
 
     zone.updateProperty( S_X, "1", x[1] );
 
+    if( p_step_flows )
+    {
+      p_step_flows->update(
+        zone,
+        zone.getNetView( EVOLUTION_NETWORK ),
+        p_view ? p_view : zone.getNetView( EVOLUTION_NETWORK )
+      );
+    }
+
+    if( p_flows )
+    {
+      p_flows->accumulate( *p_step_flows, d_dt );
+    }
+
+    if( p_sdot_breakdown )
+    {
+      p_sdot_breakdown->update(
+        zone,
+        p_view ? p_view : zone.getNetView( EVOLUTION_NETWORK ),
+        *p_step_flows,
+        d_dt
+      );
+    }
+
+    if( p_summary )
+    {
+      p_summary->update(
+        d_t,
+        d_dt,
+        zone.getProperty<double>( nnt::s_T9 ),
+        my_user::rho_function( param_map, x ),
+        xold[2],
+        x[2]
+      );
+    }
+
+    if(
+      p_freezeout &&
+      p_freezeout->update(
+        zone,
+        d_t - d_dt,
+        d_dt,
+        ( x[2] - xold[2] ) / d_dt,
+        x[2]
+      )
+    )
+    {
+      b_frozen = true;
+      b_stop =
+        boost::any_cast<std::string>( param_map[S_FREEZEOUT_ACTION] ) ==
+          S_FREEZEOUT_STOP;
+      zone.updateProperty( S_DETECTED_FREEZEOUT_TIME, p_freezeout->time() );
+      my_user::log_message(
+        my_user::LOG_INFO,
+        ( boost::format( "Freeze-out at t = %g" ) % p_freezeout->time() ).str()
+      );
+    }
+
   //============================================================================
   // Output step data.
   //============================================================================
@@ -1029,36 +1745,84 @@ int main( int argc, char * argv[] ) {
         d_t % x[0] % x[1] % x[2];
       std::cout << boost::format( "-----------\n\n" );
     }
+    else if( p_observer )
+    {
+      p_observer->step( x, d_t, d_dt );
+    }
+
+  //============================================================================
+  // Write snapshots at events in the step.
+  //============================================================================
+
+    if( p_events )
+    {
+      p_events->update( zone );
+      while( p_events->next( zone ) )
+      {
+        write_dump(
+          p_my_nucnet,
+          zone,
+          ++k,
+          p_abundance_log,
+          p_snapshot_writer,
+          p_store,
+          p_my_output,
+          argv[3],
+          boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+        );
+      }
+      p_events->restore( zone );
+    }
 
   //============================================================================
   // Print out abundances.
   //============================================================================
 
     if( i_step++ % boost::any_cast<size_t>( param_map[nnt::s_STEPS] ) == 0 ||
-        d_t >= boost::any_cast<double>( param_map[nnt::s_TEND] )
+        d_t >= boost::any_cast<double>( param_map[nnt::s_TEND] ) ||
+        b_stop
     )
     {
-      sprintf( s_property, "%d", ++k );
-      Libnucnet__relabelZone(
+      write_dump(
         p_my_nucnet,
-        zone.getNucnetZone(),
-        s_property,
-        NULL,
-        NULL
+        zone,
+        ++k,
+        p_abundance_log,
+        p_snapshot_writer,
+        p_store,
+        p_my_output,
+        argv[3],
+        boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+      );
+    }
+
+  //============================================================================
+  // Publish progress.
+  //============================================================================
+
+    if( p_progress )
+    {
+      p_progress->update(
+        zone,
+        zone.getNetView( EVOLUTION_NETWORK ),
+        i_step,
+        d_t,
+        d_dt,
+        x[2]
       );
-      nnt::print_zone_abundances( zone );
-      nnt::write_xml( p_my_output, zone.getNucnetZone() );
-      if( B_OUTPUT_EVERY_TIME_DUMP )
-      {
-        Libnucnet__writeToXmlFile( p_my_output, argv[3] );
-      }
     }
 
+  //============================================================================
+  // Stop at freeze-out if desired.
+  //============================================================================
+
+    if( b_stop ) break;
+
   //============================================================================
   // Limit network.
   //============================================================================
 
-  user::limit_evolution_network( zone, D_LIM_CUTOFF );
+  (*p_limiter)( zone );
 
   //============================================================================
   // Update timestep.
@@ -1072,34 +1836,191 @@ int main( int argc, char * argv[] ) {
         d_h = GSL_MIN( d_h, D_X_REG_T * d_dt / delta );
     }
 
-    Libnucnet__Zone__updateTimeStep(
-      zone.getNucnetZone(),
-      &d_dt,
-      D_REG_T,
-      D_REG_Y,
-      D_Y_MIN_DT
+    (*p_step_controller)(
+      zone,
+      d_dt,
+      boost::bind(
+        hydro_change, boost::ref( zone ), boost::cref( x ), p_t9_predictor,
+        d_t, _1
+      ),
+      d_dt / d_h
     );
 
-    if( d_dt > d_h ) d_dt = d_h;
+    if( !p_step_controller->controlsHydro() && d_dt > d_h ) d_dt = d_h;
+
+    // The evolver's suggestion can only shorten the controller's step.
+
+    if( p_evolver && p_evolver->suggestedStep() > 0 )
+    {
+      d_dt = GSL_MIN( p_evolver->suggestedStep(), d_dt );
+    }
 
     if ( d_t + d_dt > boost::any_cast<double>( param_map[nnt::s_TEND] ) )
     {
       d_dt = boost::any_cast<double>( param_map[nnt::s_TEND] ) - d_t;
     }
 
+  //============================================================================
+  // Stop after the probe steps if only estimating the cost.
+  //============================================================================
+
+    if(
+      p_cost &&
+      p_cost->probe_step( i_step, d_dt ) &&
+      b_estimate
+    )
+    {
+      break;
+    }
+
+  //============================================================================
+  // Stop for a checkpoint near the wall-time budget or on a signal.
+  //============================================================================
+
+    if(
+      p_budget->update( d_t, boost::any_cast<double>( param_map[nnt::s_TEND] ) )
+    )
+    {
+      b_checkpoint = true;
+      break;
+    }
+
   }  
 
+  //============================================================================
+  // Write the checkpoint before the output.
+  //============================================================================
+
+  if( b_checkpoint )
+  {
+    my_user::write_checkpoint(
+      s_checkpoint, zone, x, d_t, d_dt, k, i_step, b_frozen
+    );
+    my_user::log_message(
+      my_user::LOG_WARN,
+      (
+        boost::format( "Checkpoint at t = %g written to %s" ) %
+        d_t % s_checkpoint
+      ).str()
+    );
+  }
+
   //============================================================================
   // Write output.
   //============================================================================
 
-  Libnucnet__writeToXmlFile( p_my_output, argv[3] );
+  if( p_snapshot_writer )
+  {
+    p_snapshot_writer->close();
+  }
+  else if( p_summary )
+  {
+    p_summary->write(
+      argv[3],
+      zone,
+      boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+    );
+  }
+  else if( p_store )
+  {
+    p_store->write( argv[3] );
+  }
+  else if( p_my_output )
+  {
+    my_user::write_xml_output(
+      p_my_output,
+      argv[3],
+      boost::any_cast<int>( param_map[S_COMPRESS_LEVEL] )
+    );
+  }
+
+  if( p_flows )
+  {
+    p_flows->write(
+      boost::any_cast<std::string>( param_map[S_FLOW_OUTPUT] )
+    );
+  }
+
+  if( p_sdot_breakdown )
+  {
+    p_sdot_breakdown->report( std::cout );
+  }
+
+  if( p_adaptive_sdot )
+  {
+    p_adaptive_sdot->report( std::cout );
+  }
+
+  if( my_user::log_enabled( my_user::LOG_INFO ) )
+  {
+    p_limiter->report( std::cout );
+    p_step_controller->report( std::cout );
+    if( p_t9_predictor ) p_t9_predictor->report( std::cout, i_step );
+    if( p_evolver ) p_evolver->report( std::cout );
+    if( p_decay ) p_decay->report( std::cout );
+    if( p_freezeout ) p_freezeout->report( std::cout );
+    if( p_events ) p_events->report( std::cout );
+    p_budget->report( std::cout );
+  }
+
+  //============================================================================
+  // Print the cost estimate, or log the timing of a complete run.
+  //============================================================================
+
+  if( p_cost )
+  {
+    if( b_estimate )
+    {
+      p_cost->predict(
+        param_map.find( S_TIMING_LOG ) != param_map.end() ?
+          boost::any_cast<std::string>( param_map[S_TIMING_LOG] ) :
+          std::string(),
+        std::cout
+      );
+    }
+    else if(
+      !b_checkpoint && param_map.find( S_RESTART ) == param_map.end()
+    )
+    {
+      p_cost->append(
+        boost::any_cast<std::string>( param_map[S_TIMING_LOG] ),
+        my_user::wall_time() - d_wall_start,
+        i_step,
+        argv[3]
+      );
+    }
+  }
 
   //============================================================================
   // Clean up and exit.
   //============================================================================
 
+  delete p_snapshot_writer;
+  delete p_summary;
+  delete p_store;
+  delete p_flows;
+  delete p_sdot_breakdown;
+  delete p_step_flows;
+  delete p_adaptive_sdot;
+  delete p_limiter;
+  delete p_step_controller;
+  delete p_t9_predictor;
+  delete p_evolver;
+  delete p_decay;
+  delete p_freezeout;
+  delete p_events;
+  delete p_observer;
+  if( p_progress )
+    p_progress->finish(
+      b_checkpoint ? my_user::PROGRESS_CHECKPOINTED : my_user::PROGRESS_DONE
+    );
+  delete p_progress;
+  delete p_budget;
+  delete p_cost;
+  delete p_reaction_index;
+  delete p_abundance_log;
+  if( p_my_output ) Libnucnet__free( p_my_output );
   Libnucnet__free( p_my_nucnet );
-  return EXIT_SUCCESS;
+  return b_checkpoint ? I_CHECKPOINT_STATUS : EXIT_SUCCESS;
 
 }
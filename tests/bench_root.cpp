@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file bench_root.cpp
+//! \brief A micro-benchmark of root function evaluations per solve for
+//!        adaptive_1d_root() and for a fixed-factor bracket expansion.
+//!
+//! Usage: bench_root [factor]
+//!
+//! The model function is f(x) = x^p - r^p with the guess at x = 1, so the
+//! root sits at a relative distance r - 1 from the guess.  The power p
+//! stands in for the steep dependence of the T9 root function on T9.  The
+//! fixed column counts only the evaluations to bracket the root by
+//! expanding by the factor (default 1.001) on both sides, as
+//! nnt::compute_1d_root does, so it is a lower bound on that solve.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/ref.hpp>
+
+#include "my_root_helper.h"
+
+#define I_BENCH_MAX_FIXED  1000000  /* Most fixed-factor expansions */
+
+//##############################################################################
+// power_root().
+//##############################################################################
+
+double
+power_root( double d_x, double d_p, double d_r, size_t& i_evaluations )
+{
+
+  i_evaluations++;
+
+  return pow( d_x, d_p ) - pow( d_r, d_p );
+
+}
+
+//##############################################################################
+// fixed_bracket_evaluations().
+//##############################################################################
+
+size_t
+fixed_bracket_evaluations( double d_p, double d_r, double d_factor )
+{
+
+  size_t i_evaluations = 0;
+  double d_lo = 1., d_hi = 1.;
+  double f_lo = power_root( d_lo, d_p, d_r, i_evaluations );
+  double f_hi = f_lo;
+
+  while( ( f_lo > 0 ) == ( f_hi > 0 ) && f_lo != 0 && f_hi != 0 )
+  {
+    if( i_evaluations > I_BENCH_MAX_FIXED ) return 0;
+    d_lo /= d_factor;
+    d_hi *= d_factor;
+    f_lo = power_root( d_lo, d_p, d_r, i_evaluations );
+    f_hi = power_root( d_hi, d_p, d_r, i_evaluations );
+  }
+
+  return i_evaluations;
+
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int
+main( int argc, char * argv[] )
+{
+
+  double d_factor = argc > 1 ? atof( argv[1] ) : 1.001;
+  double a_p[] = { 1., 10. };
+  double a_r[] = { 1.0005, 0.99, 1.2, 0.5, 10., 1.e-3, 1.e30 };
+  double a_step[] = { 1.e-3, 0.1 };
+
+  if( d_factor <= 1. )
+  {
+    std::cerr << "Factor must be greater than one." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout <<
+    boost::format( "%5s %10s %8s %10s %10s %12s\n" ) %
+    "p" % "root" % "step" % "adaptive" % "fixed" % "rel. error";
+
+  for( size_t ip = 0; ip < sizeof( a_p ) / sizeof( double ); ip++ )
+  {
+    for( size_t ir = 0; ir < sizeof( a_r ) / sizeof( double ); ir++ )
+    {
+      for( size_t is = 0; is < sizeof( a_step ) / sizeof( double ); is++ )
+      {
+
+        size_t i_evaluations = 0;
+
+        double d_x =
+          my_user::adaptive_1d_root(
+            boost::bind(
+              power_root, _1, a_p[ip], a_r[ir], boost::ref( i_evaluations )
+            ),
+            1.,
+            a_step[is]
+          );
+
+        size_t i_fixed =
+          fixed_bracket_evaluations( a_p[ip], a_r[ir], d_factor );
+
+        std::cout <<
+          boost::format( "%5g %10.4e %8.1e %10lu %10s %12.3e\n" ) %
+          a_p[ip] %
+          a_r[ir] %
+          a_step[is] %
+          i_evaluations %
+          ( i_fixed ? boost::str( boost::format( "%lu" ) % i_fixed ) : ">1e6" ) %
+          ( fabs( d_x - a_r[ir] ) / a_r[ir] );
+
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+
+}
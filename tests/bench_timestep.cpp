@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file bench_timestep.cpp
+//! \brief A micro-benchmark of the time step controllers on the mock zone.
+//!
+//! Usage: bench_timestep [tau]
+//!
+//! The network is the Robertson problem of the mock zone in tests/mock,
+//! taken by backward Euler steps from y = (1, 0, 0) to t = 4e5, as
+//! user::evolve() steps the network.  The hydro is a model expansion with
+//! rho = rho_0 exp(-t / tau) (default tau = 1e4), so the hydro forecast over
+//! a step h is 1 - exp(-h / tau).  The standard and PI controllers stand in
+//! for the driver's hydro step with the largest step over which rho changes
+//! by the hydro regulator.  Each row gives the steps taken and the relative
+//! errors in y1 and y3 against the reference of check_evolvers.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+
+#include "my_timestep_helper.h"
+#include "user/evolve.h"
+#include "tests/mock/mock_zone.h"
+
+#define D_BENCH_T_END       4.e5
+#define D_BENCH_DT_0        1.e-6
+#define D_BENCH_REG         0.15     /* The driver's regulators */
+#define D_BENCH_Y_MIN       1.e-10
+#define D_BENCH_NEWTON      1.e-12   /* Relative Newton convergence */
+#define I_BENCH_MAX_NEWTON  20       /* Most Newton iterations per step */
+
+//##############################################################################
+// Reference solution at t = 4e5, as in check_evolvers.
+//##############################################################################
+
+static const double a_reference[I_MOCK_SPECIES] =
+  { 4.93827452e-3, 1.98499409e-8, 9.95061706e-1 };
+
+//##############################################################################
+// expansion_change().  The relative change of rho over a step of d_h.
+//##############################################################################
+
+double
+expansion_change( double d_tau, double d_h )
+{
+
+  return 1. - exp( -d_h / d_tau );
+
+}
+
+//##############################################################################
+// backward_euler_step().  One step, with the abundance changes recorded for
+// the controllers.
+//##############################################################################
+
+void
+backward_euler_step( nnt::Zone& zone, double d_dt )
+{
+
+  std::vector<double> y0( I_MOCK_SPECIES ), y( I_MOCK_SPECIES );
+
+  mock_zone_get( &y0[0] );
+  y = y0;
+
+  for( size_t n = 0; n < I_BENCH_MAX_NEWTON; n++ )
+  {
+
+    bool b_converged = true;
+
+    gsl_vector * p_f = Libnucnet__Zone__computeFlowVector( NULL );
+    WnMatrix * p_matrix = Libnucnet__Zone__computeJacobian( NULL );
+
+    WnMatrix__addValueToDiagonals( p_matrix, 1. / d_dt );
+
+    for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+      p_f->data[i] -= ( y[i] - y0[i] ) / d_dt;
+
+    gsl_vector * p_dy = user::solve_matrix_for_zone( zone, p_matrix, p_f );
+
+    for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+    {
+      y[i] += p_dy->data[i];
+      if( fabs( p_dy->data[i] ) > D_BENCH_NEWTON * fabs( y[i] ) )
+        b_converged = false;
+    }
+
+    mock_zone_set( y[0], y[1], y[2] );
+
+    gsl_vector_free( p_dy );
+    gsl_vector_free( p_f );
+    WnMatrix__free( p_matrix );
+
+    if( b_converged ) break;
+
+  }
+
+  gsl_vector * p_changes = gsl_vector_alloc( I_MOCK_SPECIES );
+
+  for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+    p_changes->data[i] = y[i] - y0[i];
+
+  Libnucnet__Zone__updateAbundanceChanges( NULL, p_changes );
+
+  gsl_vector_free( p_changes );
+
+}
+
+//##############################################################################
+// run().
+//##############################################################################
+
+void
+run( const std::string& s_mode, double d_tau )
+{
+
+  nnt::Zone zone;
+  double d_t = 0, d_dt = D_BENCH_DT_0, y[I_MOCK_SPECIES];
+  double d_h = -d_tau * log( 1. - D_BENCH_REG );
+  size_t i_steps = 0;
+
+  my_user::step_controller controller(
+    s_mode, D_BENCH_REG, D_BENCH_REG, D_BENCH_REG, D_BENCH_Y_MIN, 2.,
+    0.3, 0.4
+  );
+
+  mock_zone_set( 1., 0., 0. );
+
+  while( d_t < D_BENCH_T_END )
+  {
+
+    backward_euler_step( zone, d_dt );
+
+    d_t += d_dt;
+    i_steps++;
+
+    controller(
+      zone,
+      d_dt,
+      boost::bind( expansion_change, d_tau, _1 ),
+      d_dt / d_h
+    );
+
+    if( !controller.controlsHydro() && d_dt > d_h ) d_dt = d_h;
+
+    if( d_t + d_dt > D_BENCH_T_END ) d_dt = D_BENCH_T_END - d_t;
+
+  }
+
+  mock_zone_get( y );
+
+  std::cout <<
+    boost::format( "%-12s %8lu %12.3e %12.3e\n" ) %
+    s_mode %
+    i_steps %
+    ( fabs( y[0] - a_reference[0] ) / a_reference[0] ) %
+    ( fabs( y[2] - a_reference[2] ) / a_reference[2] );
+
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int
+main( int argc, char * argv[] )
+{
+
+  double d_tau = argc > 1 ? atof( argv[1] ) : 1.e4;
+
+  if( d_tau <= 0 )
+  {
+    std::cerr << "Tau must be positive." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout <<
+    boost::format( "%-12s %8s %12s %12s\n" ) %
+    "controller" % "steps" % "y1 error" % "y3 error";
+
+  run( S_DT_STANDARD, d_tau );
+  run( S_DT_PREDICTIVE, d_tau );
+  run( S_DT_PI, d_tau );
+
+  return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file check_evolvers.cpp
+//! \brief Check the network evolvers on the Robertson stiff problem.
+//!
+//! Usage: check_evolvers
+//!
+//! The evolvers run on the mock zone in tests/mock, which holds the three
+//! species of the Robertson problem, from y = (1, 0, 0) to t = 4e5 at rtol
+//! 1e-4.  The driver takes the suggested step after each call.  The BDF
+//! evolver also runs with the trial calls the hydro stepper makes, whose
+//! abundances are then restored.  Each result must match the reference to
+//! D_CHECK_TOLERANCE in y1 and y3.
+//!
+//! The JFNK evolver takes one backward Euler step per call, so its error is
+//! set by the driver step.  It runs with steps that grow by D_CHECK_GROWTH
+//! and must match backward Euler with direct solves over the same steps.
+//! It runs with the diagonal preconditioner and with y2, the fast species,
+//! as the border.
+//! That backward Euler run forms a Jacobian and factors the matrix on each
+//! Newton iteration, as user::evolve_function() does, so its factorizations
+//! per step are the comparison for the Rosenbrock evolver.  The Rosenbrock
+//! evolver runs with the zone's solver set to arrow, as the driver sets it,
+//! which factors on every stage, and with the dense solver, which factors
+//! once per step.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "my_evolve_helper.h"
+#include "tests/mock/mock_zone.h"
+
+#define D_CHECK_T_END      4.e5
+#define D_CHECK_DT_0       1.e-6
+#define D_CHECK_RTOL       1.e-4
+#define D_CHECK_ATOL       1.e-10
+#define D_CHECK_TOLERANCE  1.e-2    /* Relative tolerance against reference */
+#define D_CHECK_GROWTH     1.2      /* Step growth without a suggestion */
+#define D_CHECK_NEWTON     1.e-12   /* Relative Newton convergence */
+#define I_CHECK_MAX_NEWTON 20       /* Most Newton iterations per step */
+
+//##############################################################################
+// Reference solution at t = 4e5, from the Rosenbrock and BDF evolvers at
+// rtol 1e-10, which agree to eight digits.
+//##############################################################################
+
+static const double a_reference[I_MOCK_SPECIES] =
+  { 4.93827452e-3, 1.98499409e-8, 9.95061706e-1 };
+
+//##############################################################################
+// backward_euler().  Backward Euler with Newton iterations on direct solves
+// over the steps the JFNK run takes.
+//##############################################################################
+
+void
+backward_euler( nnt::Zone& zone, double * p_reference )
+{
+
+  double d_t = 0, d_dt = D_CHECK_DT_0;
+  std::vector<double> y0( I_MOCK_SPECIES ), y( I_MOCK_SPECIES );
+  size_t i_steps = 0;
+
+  mock_zone_set( 1., 0., 0. );
+  mock_zone_reset_counts();
+
+  while( d_t < D_CHECK_T_END )
+  {
+
+    mock_zone_get( &y0[0] );
+    y = y0;
+
+    for( size_t n = 0; n < I_CHECK_MAX_NEWTON; n++ )
+    {
+
+      bool b_converged = true;
+
+      gsl_vector * p_f = Libnucnet__Zone__computeFlowVector( NULL );
+      WnMatrix * p_matrix = Libnucnet__Zone__computeJacobian( NULL );
+
+      WnMatrix__addValueToDiagonals( p_matrix, 1. / d_dt );
+
+      for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+        p_f->data[i] -= ( y[i] - y0[i] ) / d_dt;
+
+      gsl_vector * p_dy =
+        user::solve_matrix_for_zone( zone, p_matrix, p_f );
+
+      for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+      {
+        y[i] += p_dy->data[i];
+        if( fabs( p_dy->data[i] ) > D_CHECK_NEWTON * fabs( y[i] ) )
+          b_converged = false;
+      }
+
+      mock_zone_set( y[0], y[1], y[2] );
+
+      gsl_vector_free( p_dy );
+      gsl_vector_free( p_f );
+      WnMatrix__free( p_matrix );
+
+      if( b_converged ) break;
+
+    }
+
+    i_steps++;
+    d_t += d_dt;
+    d_dt *= D_CHECK_GROWTH;
+    if( d_t + d_dt > D_CHECK_T_END ) d_dt = D_CHECK_T_END - d_t;
+
+  }
+
+  mock_zone_get( p_reference );
+
+  std::cout <<
+    boost::format(
+      "backward Euler: %lu steps, %.2f Jacobians and %.2f factorizations"
+      " per step\n"
+    ) %
+    i_steps %
+    ( (double) mock_zone_jacobians() / i_steps ) %
+    ( (double) mock_zone_factorizations() / i_steps );
+
+}
+
+//##############################################################################
+// run().  Returns true if the evolver reaches the reference.
+//##############################################################################
+
+bool
+run(
+  const std::string& s_name,
+  nnt::Zone& zone,
+  my_user::network_evolver& evolver,
+  bool b_trials,
+  const double * p_reference
+)
+{
+
+  double d_t = 0, d_dt = D_CHECK_DT_0, y[I_MOCK_SPECIES];
+  size_t i_calls = 0;
+  bool b_ok = true;
+
+  mock_zone_set( 1., 0., 0. );
+  mock_zone_reset_counts();
+
+  while( d_t < D_CHECK_T_END )
+  {
+
+    if( b_trials )
+    {
+      mock_zone_get( y );
+      evolver( zone.getNetView( EVOLUTION_NETWORK ), 0.5 * d_dt );
+      mock_zone_set( y[0], y[1], y[2] );
+      evolver( zone.getNetView( EVOLUTION_NETWORK ), d_dt );
+      mock_zone_set( y[0], y[1], y[2] );
+    }
+
+    evolver( zone.getNetView( EVOLUTION_NETWORK ), d_dt );
+
+    d_t += d_dt;
+    i_calls++;
+
+    d_dt =
+      evolver.suggestedStep() > 0 ?
+      evolver.suggestedStep() :
+      D_CHECK_GROWTH * d_dt;
+
+    if( d_t + d_dt > D_CHECK_T_END ) d_dt = D_CHECK_T_END - d_t;
+
+  }
+
+  mock_zone_get( y );
+
+  for( size_t i = 0; i < I_MOCK_SPECIES; i += 2 )
+  {
+    if(
+      fabs( y[i] - p_reference[i] ) > D_CHECK_TOLERANCE * p_reference[i]
+    )
+      b_ok = false;
+  }
+
+  std::cout <<
+    boost::format(
+      "%-16s %s: y = (%.6e, %.6e, %.6e), %lu calls, %lu flow vectors,"
+      " %lu Jacobians, %lu zone solves"
+    ) %
+    s_name %
+    ( b_ok ? "ok" : "FAILED" ) %
+    y[0] % y[1] % y[2] %
+    i_calls %
+    mock_zone_flow_vectors() %
+    mock_zone_jacobians() %
+    mock_zone_factorizations();
+
+  evolver.report( std::cout );
+
+  return b_ok;
+
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int
+main()
+{
+
+  nnt::Zone zone;
+  double a_euler[I_MOCK_SPECIES];
+  bool b_ok = true;
+
+  my_user::bdf_evolver bdf( zone, D_CHECK_RTOL, D_CHECK_ATOL, I_BDF_MAX_ORDER );
+  b_ok &= run( "bdf", zone, bdf, false, a_reference );
+
+  my_user::bdf_evolver bdf_trials(
+    zone, D_CHECK_RTOL, D_CHECK_ATOL, I_BDF_MAX_ORDER
+  );
+  b_ok &= run( "bdf with trials", zone, bdf_trials, true, a_reference );
+
+  mock_zone_set_solver( nnt::s_ARROW );
+
+  my_user::rosenbrock_evolver rosenbrock_arrow(
+    zone, D_CHECK_RTOL, D_CHECK_ATOL
+  );
+  b_ok &= run( "rosenbrock arrow", zone, rosenbrock_arrow, false, a_reference );
+
+  my_user::rosenbrock_evolver rosenbrock_dense(
+    zone, D_CHECK_RTOL, D_CHECK_ATOL, true
+  );
+  b_ok &= run( "rosenbrock dense", zone, rosenbrock_dense, false, a_reference );
+
+  mock_zone_set_solver( "" );
+
+  backward_euler( zone, a_euler );
+
+  my_user::jfnk_evolver jfnk( zone, D_CHECK_RTOL, D_CHECK_ATOL );
+  b_ok &= run( "jfnk", zone, jfnk, false, a_euler );
+
+  my_user::jfnk_evolver jfnk_border( zone, D_CHECK_RTOL, D_CHECK_ATOL, "y2" );
+  b_ok &= run( "jfnk border", zone, jfnk_border, false, a_euler );
+
+  return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
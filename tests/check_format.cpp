@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017 Clemson University.
+//
+// This file was originally written by Bradley S. Meyer.
+//
+// This is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this software; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307
+// USA
+//
+//////////////////////////////////////////////////////////////////////////////*/
+
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file check_format.cpp
+//! \brief Check that format_double() output reads back to the same double.
+//!
+//! Usage: check_format [count]
+//!
+//! The doubles are special values (signed zeros, subnormals, the extremes,
+//! infinities, NaN) and count random bit patterns (default 1000000).  A
+//! finite double must read back with the same bits, so -0 must keep its
+//! sign.  The output must also fit in I_FORMAT_BUFFER_SIZE characters.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <boost/cstdint.hpp>
+
+#include "my_format_helper.h"
+
+//##############################################################################
+// get_bits().
+//##############################################################################
+
+boost::uint64_t
+get_bits( double d_x )
+{
+
+  boost::uint64_t bits;
+
+  std::memcpy( &bits, &d_x, sizeof( bits ) );
+
+  return bits;
+
+}
+
+//##############################################################################
+// check().  Returns true if d_x formats and reads back correctly.
+//##############################################################################
+
+bool
+check( double d_x )
+{
+
+  char s_buffer[I_FORMAT_BUFFER_SIZE];
+  size_t i_len;
+  double d_y;
+
+  i_len = my_user::format_double( s_buffer, d_x );
+
+  if( i_len + 1 > I_FORMAT_BUFFER_SIZE || i_len != strlen( s_buffer ) )
+  {
+    std::cerr << "Bad length " << i_len << " for " << s_buffer << std::endl;
+    return false;
+  }
+
+  d_y = strtod( s_buffer, NULL );
+
+  if( d_x != d_x ) return d_y != d_y;
+
+  if( get_bits( d_y ) != get_bits( d_x ) )
+  {
+    char s_exact[64];
+    snprintf( s_exact, sizeof( s_exact ), "%.17e", d_x );
+    std::cerr <<
+      s_exact << " formatted as " << s_buffer << " reads back as " << d_y <<
+      std::endl;
+    return false;
+  }
+
+  return true;
+
+}
+
+//##############################################################################
+// main().
+//##############################################################################
+
+int
+main( int argc, char * argv[] )
+{
+
+  long l_count = argc > 1 ? atol( argv[1] ) : 1000000;
+  long l_failures = 0;
+  boost::uint64_t u_state = 88172645463325252ULL;
+  double d_x;
+
+  double a_specials[] =
+  {
+    0., -0., 1., -1., 0.1, -0.1, 1.e23, 9007199254740993.,
+    5.e-324, -5.e-324, 2.2250738585072009e-308, 2.2250738585072014e-308,
+    1.7976931348623157e308, -1.7976931348623157e308, HUGE_VAL, -HUGE_VAL,
+    std::sqrt( -1. )
+  };
+
+  for( size_t i = 0; i < sizeof( a_specials ) / sizeof( double ); i++ )
+    if( !check( a_specials[i] ) ) l_failures++;
+
+  //============================================================================
+  // Random bit patterns from a xorshift generator.
+  //============================================================================
+
+  for( long l = 0; l < l_count; l++ )
+  {
+    u_state ^= u_state << 13;
+    u_state ^= u_state >> 7;
+    u_state ^= u_state << 17;
+    std::memcpy( &d_x, &u_state, sizeof( d_x ) );
+    if( !check( d_x ) ) l_failures++;
+  }
+
+  if( l_failures )
+  {
+    std::cerr << l_failures << " doubles did not round trip." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout <<
+    "format_double: " << l_count + sizeof( a_specials ) / sizeof( double ) <<
+    " doubles round trip." << std::endl;
+
+  return EXIT_SUCCESS;
+
+}
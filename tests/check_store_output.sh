@@ -0,0 +1,45 @@
+#!/bin/sh
+#///////////////////////////////////////////////////////////////////////////////
+#  This is free software; you can redistribute it and/or modify it
+#  under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2 of the License, or
+#  (at your option) any later version.
+#///////////////////////////////////////////////////////////////////////////////
+
+#///////////////////////////////////////////////////////////////////////////////
+#//! \file check_store_output.sh
+#//! \brief Check that run_entropy --output_mode store writes the same bytes
+#//!        as the default full output.
+#//!
+#//! Usage: check_store_output.sh run_entropy net_xml zone_xml [options]
+#//!
+#//! The options are passed to both runs.  Use a zone file with more than one
+#//! zone to check that only the run's snapshots reach the output.
+#///////////////////////////////////////////////////////////////////////////////
+
+if [ $# -lt 3 ]; then
+  echo "Usage: $0 run_entropy net_xml zone_xml [options]" >&2
+  exit 2
+fi
+
+exe=$1
+net=$2
+zone=$3
+shift 3
+
+dir=`mktemp -d`
+trap 'rm -rf "$dir"' EXIT
+
+"$exe" "$net" "$zone" "$dir/full.xml" --output_mode full "$@" \
+  > "$dir/full.log" 2>&1 || { cat "$dir/full.log"; exit 1; }
+
+"$exe" "$net" "$zone" "$dir/store.xml" --output_mode store "$@" \
+  > "$dir/store.log" 2>&1 || { cat "$dir/store.log"; exit 1; }
+
+if cmp "$dir/full.xml" "$dir/store.xml"; then
+  echo "check_store_output: store output matches full output"
+else
+  diff "$dir/full.xml" "$dir/store.xml" | head -20
+  echo "check_store_output: store output differs from full output"
+  exit 1
+fi
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file Libnucnet.h
+//! \brief A mock of the Libnucnet zone calls made by the network evolvers.
+//!
+//! The zone holds the Robertson stiff problem in place of a network.  See
+//! mock_zone.h.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_LIBNUCNET_H
+#define MOCK_LIBNUCNET_H
+
+#include <cstddef>
+
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+
+typedef struct Libnucnet__Zone Libnucnet__Zone;
+typedef struct Libnucnet__Net Libnucnet__Net;
+typedef struct Libnucnet__NetView Libnucnet__NetView;
+typedef struct Libnucnet__Nuc Libnucnet__Nuc;
+typedef struct Libnucnet__Reac Libnucnet__Reac;
+typedef struct Libnucnet__Reaction Libnucnet__Reaction;
+typedef struct Libnucnet__Reaction__Element Libnucnet__Reaction__Element;
+typedef struct Libnucnet__Species Libnucnet__Species;
+typedef struct WnMatrix WnMatrix;
+
+gsl_vector * Libnucnet__Zone__getAbundances( const Libnucnet__Zone * );
+void Libnucnet__Zone__updateAbundances( Libnucnet__Zone *, gsl_vector * );
+void Libnucnet__Zone__updateAbundanceChanges( Libnucnet__Zone *, gsl_vector * );
+gsl_vector * Libnucnet__Zone__getAbundanceChanges( Libnucnet__Zone * );
+int
+Libnucnet__Zone__updateTimeStep(
+  Libnucnet__Zone *, double *, double, double, double
+);
+void Libnucnet__Zone__computeRates( Libnucnet__Zone *, double, double );
+gsl_vector * Libnucnet__Zone__computeFlowVector( Libnucnet__Zone * );
+WnMatrix * Libnucnet__Zone__computeJacobian( Libnucnet__Zone * );
+Libnucnet__Net * Libnucnet__Zone__getNet( Libnucnet__Zone * );
+
+Libnucnet__Nuc * Libnucnet__Net__getNuc( Libnucnet__Net * );
+Libnucnet__Reac * Libnucnet__Net__getReac( Libnucnet__Net * );
+Libnucnet__Net * Libnucnet__NetView__getNet( Libnucnet__NetView * );
+Libnucnet__Species *
+Libnucnet__Nuc__getSpeciesByName( Libnucnet__Nuc *, const char * );
+size_t Libnucnet__Species__getIndex( Libnucnet__Species * );
+const char *
+Libnucnet__Reaction__Element__getName( Libnucnet__Reaction__Element * );
+
+void WnMatrix__free( WnMatrix * );
+void WnMatrix__addValueToDiagonals( WnMatrix *, double );
+gsl_vector * WnMatrix__getDiagonalElements( WnMatrix * );
+gsl_matrix * WnMatrix__getGslMatrix( WnMatrix * );
+
+#endif // MOCK_LIBNUCNET_H
@@ -0,0 +1,454 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file mock_zone.cpp
+//! \brief The mock zone for the evolver check.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+//##############################################################################
+// Includes.
+//##############################################################################
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "nnt/iter.h"
+#include "nnt/string_defs.h"
+#include "user/evolve.h"
+#include "user/flow_utilities.h"
+
+#include "mock_zone.h"
+
+//##############################################################################
+// State.
+//##############################################################################
+
+struct WnMatrix
+{
+  double a[I_MOCK_SPECIES][I_MOCK_SPECIES];
+};
+
+struct Libnucnet__NetView
+{
+  int i;
+};
+
+struct Libnucnet__Species
+{
+  size_t iIndex;
+};
+
+struct Libnucnet__Reaction__Element
+{
+  const char * sName;
+};
+
+struct Libnucnet__Reaction
+{
+  size_t iIndex;
+  std::vector<Libnucnet__Reaction__Element> reactants, products;
+};
+
+static double y[I_MOCK_SPECIES], dy[I_MOCK_SPECIES];
+static Libnucnet__NetView evolution_view;
+static Libnucnet__Species species[I_MOCK_SPECIES] = { { 0 }, { 1 }, { 2 } };
+static Libnucnet__Reaction__Element
+  elements[I_MOCK_SPECIES] = { { "y1" }, { "y2" }, { "y3" } };
+static std::string s_solver;
+static size_t i_flow_vectors = 0, i_jacobians = 0, i_factorizations = 0;
+
+//##############################################################################
+// Control.
+//##############################################################################
+
+void
+mock_zone_set( double d_y1, double d_y2, double d_y3 )
+{
+  y[0] = d_y1;
+  y[1] = d_y2;
+  y[2] = d_y3;
+}
+
+void
+mock_zone_get( double * p_y )
+{
+  std::copy( y, y + I_MOCK_SPECIES, p_y );
+}
+
+void
+mock_zone_set_solver( const std::string& s )
+{
+  s_solver = s;
+}
+
+void
+mock_zone_reset_counts()
+{
+  i_flow_vectors = i_jacobians = i_factorizations = 0;
+}
+
+size_t
+mock_zone_flow_vectors()
+{
+  return i_flow_vectors;
+}
+
+size_t
+mock_zone_jacobians()
+{
+  return i_jacobians;
+}
+
+size_t
+mock_zone_factorizations()
+{
+  return i_factorizations;
+}
+
+//##############################################################################
+// reactions().  The three reactions of the problem.
+//##############################################################################
+
+static std::vector<Libnucnet__Reaction>&
+reactions()
+{
+
+  static std::vector<Libnucnet__Reaction> v;
+
+  if( v.empty() )
+  {
+    const size_t a[3][4] = { { 0, 3, 1, 3 }, { 1, 2, 0, 2 }, { 1, 1, 2, 1 } };
+    v.resize( 3 );
+    for( size_t i = 0; i < 3; i++ )
+    {
+      v[i].iIndex = i;
+      for( size_t j = 0; j < 2; j++ )
+      {
+        if( a[i][j] < I_MOCK_SPECIES )
+          v[i].reactants.push_back( elements[a[i][j]] );
+        if( a[i][j + 2] < I_MOCK_SPECIES )
+          v[i].products.push_back( elements[a[i][j + 2]] );
+      }
+    }
+  }
+
+  return v;
+
+}
+
+//##############################################################################
+// nnt::Zone.
+//##############################################################################
+
+namespace nnt
+{
+
+Libnucnet__Zone *
+Zone::getNucnetZone() const
+{
+  return NULL;
+}
+
+Libnucnet__NetView *
+Zone::getNetView( const char *, const char * )
+{
+  return &evolution_view;
+}
+
+bool
+Zone::hasProperty( const std::string& s_name ) const
+{
+  return s_name == s_SOLVER && !s_solver.empty();
+}
+
+template<> double
+Zone::getProperty<double>( const std::string& ) const
+{
+  return 1.;
+}
+
+template<> std::string
+Zone::getProperty<std::string>( const std::string& ) const
+{
+  return s_solver;
+}
+
+reaction_list_t
+make_reaction_list( Libnucnet__Reac * )
+{
+  reaction_list_t list;
+  for( size_t i = 0; i < reactions().size(); i++ )
+    list.push_back( Reaction( &reactions()[i] ) );
+  return list;
+}
+
+reaction_element_list_t
+make_reaction_nuclide_reactant_list( Libnucnet__Reaction * p_reaction )
+{
+  reaction_element_list_t list;
+  for( size_t i = 0; i < p_reaction->reactants.size(); i++ )
+    list.push_back( ReactionElement( &p_reaction->reactants[i] ) );
+  return list;
+}
+
+reaction_element_list_t
+make_reaction_nuclide_product_list( Libnucnet__Reaction * p_reaction )
+{
+  reaction_element_list_t list;
+  for( size_t i = 0; i < p_reaction->products.size(); i++ )
+    list.push_back( ReactionElement( &p_reaction->products[i] ) );
+  return list;
+}
+
+} // namespace nnt
+
+//##############################################################################
+// Libnucnet zone calls.
+//##############################################################################
+
+gsl_vector *
+Libnucnet__Zone__getAbundances( const Libnucnet__Zone * )
+{
+  gsl_vector * p_y = gsl_vector_alloc( I_MOCK_SPECIES );
+  std::copy( y, y + I_MOCK_SPECIES, p_y->data );
+  return p_y;
+}
+
+void
+Libnucnet__Zone__updateAbundances( Libnucnet__Zone *, gsl_vector * p_y )
+{
+  std::copy( p_y->data, p_y->data + I_MOCK_SPECIES, y );
+}
+
+void
+Libnucnet__Zone__updateAbundanceChanges( Libnucnet__Zone *, gsl_vector * p_dy )
+{
+  std::copy( p_dy->data, p_dy->data + I_MOCK_SPECIES, dy );
+}
+
+gsl_vector *
+Libnucnet__Zone__getAbundanceChanges( Libnucnet__Zone * )
+{
+  gsl_vector * p_dy = gsl_vector_alloc( I_MOCK_SPECIES );
+  std::copy( dy, dy + I_MOCK_SPECIES, p_dy->data );
+  return p_dy;
+}
+
+//##############################################################################
+// Libnucnet__Zone__updateTimeStep().  Libnucnet's rule: grow by 1 + regt
+// unless some abundance above the minimum changed by more than regy of
+// itself over the last step.
+//##############################################################################
+
+int
+Libnucnet__Zone__updateTimeStep(
+  Libnucnet__Zone *, double * p_dt, double d_regt, double d_regy,
+  double d_ymin
+)
+{
+
+  double d_dt = ( 1. + d_regt ) * *p_dt;
+
+  for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+  {
+    if( y[i] > d_ymin && dy[i] != 0 )
+      d_dt = std::min( d_dt, d_regy * y[i] / fabs( dy[i] ) * *p_dt );
+  }
+
+  *p_dt = d_dt;
+
+  return 1;
+
+}
+
+void
+Libnucnet__Zone__computeRates( Libnucnet__Zone *, double, double )
+{}
+
+gsl_vector *
+Libnucnet__Zone__computeFlowVector( Libnucnet__Zone * )
+{
+
+  gsl_vector * p_f = gsl_vector_alloc( I_MOCK_SPECIES );
+
+  i_flow_vectors++;
+
+  p_f->data[0] = -0.04 * y[0] + 1.e4 * y[1] * y[2];
+  p_f->data[1] = 0.04 * y[0] - 1.e4 * y[1] * y[2] - 3.e7 * y[1] * y[1];
+  p_f->data[2] = 3.e7 * y[1] * y[1];
+
+  return p_f;
+
+}
+
+WnMatrix *
+Libnucnet__Zone__computeJacobian( Libnucnet__Zone * )
+{
+
+  WnMatrix * p_matrix = new WnMatrix;
+
+  i_jacobians++;
+
+  p_matrix->a[0][0] = 0.04;
+  p_matrix->a[0][1] = -1.e4 * y[2];
+  p_matrix->a[0][2] = -1.e4 * y[1];
+  p_matrix->a[1][0] = -0.04;
+  p_matrix->a[1][1] = 1.e4 * y[2] + 6.e7 * y[1];
+  p_matrix->a[1][2] = 1.e4 * y[1];
+  p_matrix->a[2][0] = 0.;
+  p_matrix->a[2][1] = -6.e7 * y[1];
+  p_matrix->a[2][2] = 0.;
+
+  return p_matrix;
+
+}
+
+Libnucnet__Net *
+Libnucnet__Zone__getNet( Libnucnet__Zone * )
+{
+  return NULL;
+}
+
+Libnucnet__Nuc *
+Libnucnet__Net__getNuc( Libnucnet__Net * )
+{
+  return NULL;
+}
+
+Libnucnet__Reac *
+Libnucnet__Net__getReac( Libnucnet__Net * )
+{
+  return NULL;
+}
+
+Libnucnet__Net *
+Libnucnet__NetView__getNet( Libnucnet__NetView * )
+{
+  return NULL;
+}
+
+Libnucnet__Species *
+Libnucnet__Nuc__getSpeciesByName( Libnucnet__Nuc *, const char * s_name )
+{
+  std::string s( s_name );
+  if( s.size() != 2 || s[0] != 'y' || s[1] < '1' || s[1] > '3' ) return NULL;
+  return &species[s[1] - '1'];
+}
+
+size_t
+Libnucnet__Species__getIndex( Libnucnet__Species * p_species )
+{
+  return p_species->iIndex;
+}
+
+const char *
+Libnucnet__Reaction__Element__getName(
+  Libnucnet__Reaction__Element * p_element
+)
+{
+  return p_element->sName;
+}
+
+//##############################################################################
+// WnMatrix calls.
+//##############################################################################
+
+void
+WnMatrix__free( WnMatrix * p_matrix )
+{
+  delete p_matrix;
+}
+
+void
+WnMatrix__addValueToDiagonals( WnMatrix * p_matrix, double d_x )
+{
+  for( size_t i = 0; i < I_MOCK_SPECIES; i++ ) p_matrix->a[i][i] += d_x;
+}
+
+gsl_vector *
+WnMatrix__getDiagonalElements( WnMatrix * p_matrix )
+{
+  gsl_vector * p_d = gsl_vector_alloc( I_MOCK_SPECIES );
+  for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+    p_d->data[i] = p_matrix->a[i][i];
+  return p_d;
+}
+
+gsl_matrix *
+WnMatrix__getGslMatrix( WnMatrix * p_matrix )
+{
+  gsl_matrix * p_gsl = gsl_matrix_alloc( I_MOCK_SPECIES, I_MOCK_SPECIES );
+  for( size_t i = 0; i < I_MOCK_SPECIES; i++ )
+    for( size_t j = 0; j < I_MOCK_SPECIES; j++ )
+      gsl_matrix_set( p_gsl, i, j, p_matrix->a[i][j] );
+  return p_gsl;
+}
+
+//##############################################################################
+// user::solve_matrix_for_zone().  Each call factors the matrix, as the
+// zone's solvers do.
+//##############################################################################
+
+namespace user
+{
+
+gsl_vector *
+solve_matrix_for_zone( nnt::Zone&, WnMatrix * p_matrix, gsl_vector * p_rhs )
+{
+
+  WnMatrix lu = *p_matrix;
+  gsl_vector * p_x = gsl_vector_alloc( I_MOCK_SPECIES );
+  double * x = p_x->data;
+
+  i_factorizations++;
+
+  std::copy( p_rhs->data, p_rhs->data + I_MOCK_SPECIES, x );
+
+  for( size_t k = 0; k < I_MOCK_SPECIES; k++ )
+  {
+    size_t p = k;
+    for( size_t i = k + 1; i < I_MOCK_SPECIES; i++ )
+      if( fabs( lu.a[i][k] ) > fabs( lu.a[p][k] ) ) p = i;
+    for( size_t j = 0; j < I_MOCK_SPECIES; j++ )
+      std::swap( lu.a[k][j], lu.a[p][j] );
+    std::swap( x[k], x[p] );
+    for( size_t i = k + 1; i < I_MOCK_SPECIES; i++ )
+    {
+      double d_f = lu.a[i][k] / lu.a[k][k];
+      for( size_t j = k; j < I_MOCK_SPECIES; j++ )
+        lu.a[i][j] -= d_f * lu.a[k][j];
+      x[i] -= d_f * x[k];
+    }
+  }
+
+  for( size_t k = I_MOCK_SPECIES; k-- > 0; )
+  {
+    double d_s = x[k];
+    for( size_t j = k + 1; j < I_MOCK_SPECIES; j++ ) d_s -= lu.a[k][j] * x[j];
+    x[k] = d_s / lu.a[k][k];
+  }
+
+  return p_x;
+
+}
+
+//##############################################################################
+// user::compute_flows_for_reaction().
+//##############################################################################
+
+std::pair<double, double>
+compute_flows_for_reaction( nnt::Zone&, Libnucnet__Reaction * p_reaction )
+{
+
+  const double d_rate[3] = { 0.04, 1.e4, 3.e7 };
+  double d_f = d_rate[p_reaction->iIndex];
+
+  for( size_t i = 0; i < p_reaction->reactants.size(); i++ )
+    d_f *= y[p_reaction->reactants[i].sName[1] - '1'];
+
+  return std::make_pair( d_f, 0. );
+
+}
+
+} // namespace user
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file mock_zone.h
+//! \brief Control of the mock zone.
+//!
+//! The mock zone's abundances are the three species of the Robertson
+//! problem,
+//!
+//!   y1' = -0.04 y1 + 1e4 y2 y3
+//!   y2' =  0.04 y1 - 1e4 y2 y3 - 3e7 y2^2
+//!   y3' =  3e7 y2^2
+//!
+//! and its Jacobian is -dy'/dy, as Libnucnet__Zone__computeJacobian()
+//! returns.  The evolution network holds the problem's reactions,
+//!
+//!   y1 -> y2,  y2 + y3 -> y1 + y3,  y2 + y2 -> y3 + y2,
+//!
+//! with no reverse flows.  The zone's matrix solver is dense Gaussian elimination, and
+//! each call counts as a factorization.  mock_zone_set_solver() sets the
+//! zone's solver property, for example to arrow.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_ZONE_H
+#define MOCK_ZONE_H
+
+#include <cstddef>
+#include <string>
+
+#define I_MOCK_SPECIES  3
+
+void mock_zone_set( double, double, double );
+void mock_zone_get( double * );
+void mock_zone_set_solver( const std::string& );
+void mock_zone_reset_counts();
+size_t mock_zone_flow_vectors();
+size_t mock_zone_jacobians();
+size_t mock_zone_factorizations();
+
+#endif // MOCK_ZONE_H
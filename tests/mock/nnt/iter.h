@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file iter.h
+//! \brief A mock nnt::Zone for the evolver check.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_NNT_ITER_H
+#define MOCK_NNT_ITER_H
+
+#include <list>
+#include <string>
+
+#include <boost/foreach.hpp>
+
+#include "Libnucnet.h"
+
+namespace nnt
+{
+
+class Zone
+{
+
+  public:
+    Libnucnet__Zone * getNucnetZone() const;
+    Libnucnet__NetView * getNetView( const char *, const char * );
+    bool hasProperty( const std::string& ) const;
+    template<class T> T getProperty( const std::string& ) const;
+
+};
+
+class Reaction
+{
+
+  public:
+    Reaction( Libnucnet__Reaction * p ) : pReaction( p ) {}
+    Libnucnet__Reaction * getNucnetReaction() const { return pReaction; }
+
+  private:
+    Libnucnet__Reaction * pReaction;
+
+};
+
+class ReactionElement
+{
+
+  public:
+    ReactionElement( Libnucnet__Reaction__Element * p ) : pElement( p ) {}
+    Libnucnet__Reaction__Element * getNucnetReactionElement() const
+    {
+      return pElement;
+    }
+
+  private:
+    Libnucnet__Reaction__Element * pElement;
+
+};
+
+typedef std::list<Reaction> reaction_list_t;
+typedef std::list<ReactionElement> reaction_element_list_t;
+
+reaction_list_t make_reaction_list( Libnucnet__Reac * );
+reaction_element_list_t
+make_reaction_nuclide_reactant_list( Libnucnet__Reaction * );
+reaction_element_list_t
+make_reaction_nuclide_product_list( Libnucnet__Reaction * );
+
+} // namespace nnt
+
+#endif // MOCK_NNT_ITER_H
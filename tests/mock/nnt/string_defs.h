@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file string_defs.h
+//! \brief Mock nnt strings for the evolver check.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_NNT_STRING_DEFS_H
+#define MOCK_NNT_STRING_DEFS_H
+
+#define EVOLUTION_NETWORK  "evolution nuc", "evolution reac"
+
+namespace nnt
+{
+
+const char s_T9[] = "t9";
+const char s_RHO[] = "rho";
+const char s_SOLVER[] = "solver";
+const char s_ARROW[] = "arrow";
+
+} // namespace nnt
+
+#endif // MOCK_NNT_STRING_DEFS_H
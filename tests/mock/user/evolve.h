@@ -0,0 +1,20 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file evolve.h
+//! \brief The mock zone's matrix solver for the evolver check.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_USER_EVOLVE_H
+#define MOCK_USER_EVOLVE_H
+
+#include "nnt/iter.h"
+
+namespace user
+{
+
+gsl_vector * solve_matrix_for_zone( nnt::Zone&, WnMatrix *, gsl_vector * );
+
+} // namespace user
+
+#endif // MOCK_USER_EVOLVE_H
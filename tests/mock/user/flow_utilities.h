@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////
+//!
+//! \file flow_utilities.h
+//! \brief The mock zone's reaction flows for the evolver check.
+//!
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MOCK_USER_FLOW_UTILITIES_H
+#define MOCK_USER_FLOW_UTILITIES_H
+
+#include <utility>
+
+#include "nnt/iter.h"
+
+namespace user
+{
+
+std::pair<double, double>
+compute_flows_for_reaction( nnt::Zone&, Libnucnet__Reaction * );
+
+} // namespace user
+
+#endif // MOCK_USER_FLOW_UTILITIES_H